@@ -25,6 +25,7 @@
 #include "cairo-dock-separator-manager.h"
 #include "cairo-dock-applet-manager.h"
 #include "cairo-dock-class-icon-manager.h"
+#include "cairo-dock-icon-manager.h"  // cairo_dock_reset_icon_path_cache
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-dialog-factory.h"  // gldi_dialog_show_temporary_with_default_icon
 #include "cairo-dock-themes-manager.h"  // cairo_dock_update_conf_file
@@ -439,6 +440,7 @@ void cairo_dock_set_custom_icon_on_appli (const gchar *cFilePath, Icon *icon, Gl
 		cairo_dock_copy_file (cPath?cPath:cFilePath, cDestPath);
 		g_free (cDestPath);
 		g_free (cPath);
+		cairo_dock_reset_icon_path_cache ();  // the previous search of this icon may have failed or found another file
 		
 		cairo_dock_reload_icon_image (icon, pContainer);
 		cairo_dock_redraw_icon (icon);
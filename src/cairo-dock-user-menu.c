@@ -37,6 +37,7 @@
 #include "cairo-dock-separator-manager.h"
 #include "cairo-dock-applet-manager.h"
 #include "cairo-dock-class-icon-manager.h"
+#include "cairo-dock-icon-manager.h"  // cairo_dock_reset_icon_path_cache
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-module-manager.h"
 #include "cairo-dock-module-instance-manager.h"
@@ -991,6 +992,7 @@ static void _cairo_dock_remove_custom_appli_icon (G_GNUC_UNUSED GtkMenuItem *pMe
 	if (cCustomIcon != NULL)
 	{
 		g_remove (cCustomIcon);
+		cairo_dock_reset_icon_path_cache ();  // the previous search of this icon found the file we just removed
 		cairo_dock_reload_icon_image (icon, CAIRO_CONTAINER (pDock));
 		cairo_dock_redraw_icon (icon);
 	}
@@ -85,6 +85,7 @@ static void _module_widget_apply (CDWidget *pCdWidget)
 	g_return_if_fail (pKeyFile != NULL);
 
 	cairo_dock_update_keyfile_from_widget_list (pKeyFile, pCdWidget->pWidgetList);
+	gldi_module_load (pModule);  // the module may be inactive and not loaded yet.
 	if (pModule->pInterface->save_custom_widget != NULL)
 		pModule->pInterface->save_custom_widget (pModuleWidget->pModuleInstance, pKeyFile, pCdWidget->pWidgetList);  // the instance can be NULL
 	cairo_dock_write_keys_to_conf_file (pKeyFile, pModuleWidget->cConfFilePath);
@@ -134,6 +135,7 @@ static void _build_module_widget (ModuleWidget *pModuleWidget)
 	pModuleWidget->widget.pWidgetList = pWidgetList;
 	pModuleWidget->widget.pDataGarbage = pDataGarbage;
 	
+	gldi_module_load (pModuleWidget->pModule);  // the module may be inactive and not loaded yet.
 	if (pModuleWidget->pModule->pInterface->load_custom_widget != NULL)
 	{
 		pModuleWidget->pModule->pInterface->load_custom_widget (pModuleWidget->pModuleInstance, pKeyFile, pWidgetList);
@@ -137,17 +137,72 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex)  // merci a Robrob
 }
 
 
-void cairo_dock_launch_animation (GldiContainer *pContainer)
+static gboolean _on_frame_clock_tick (G_GNUC_UNUSED GtkWidget *pWidget, GdkFrameClock *pFrameClock, GldiContainer *pContainer)
+{
+	// the frame clock ticks at the refresh rate of the screen; keep the pace of the loop, which the animations rely on.
+	gint64 iFrameTime = gdk_frame_clock_get_frame_time (pFrameClock);
+	if (iFrameTime - pContainer->iLastAnimationStepTime < (gint64)pContainer->iAnimationDeltaT * 1000 - 4000)  // frames are not exactly periodic, so allow a few ms of advance.
+		return G_SOURCE_CONTINUE;
+	pContainer->iLastAnimationStepTime = iFrameTime;
+	
+	return (pContainer->iface.animation_loop (pContainer) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE);  // the loop resets iSidGLAnimation itself when it stops (the container may not exist any more).
+}
+
+static void _launch_animation_loop (GldiContainer *pContainer)
 {
 	if (pContainer->iSidGLAnimation == 0 && pContainer->iface.animation_loop != NULL)
 	{
 		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
 		pContainer->bKeepSlowAnimation = TRUE;
 		
-		pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
+		if (CAIRO_DOCK_IS_DOCK (pContainer) && gtk_widget_get_mapped (pContainer->pWidget))  // follow the frame clock, so that the steps are synchronized with the repaints; a dock that is not mapped doesn't get any frame, so it uses a timer.
+		{
+			pContainer->bAnimationOnFrameClock = TRUE;
+			pContainer->iLastAnimationStepTime = 0;
+			pContainer->iSidGLAnimation = gtk_widget_add_tick_callback (pContainer->pWidget, (GtkTickCallback) _on_frame_clock_tick, pContainer, NULL);
+		}
+		else
+		{
+			pContainer->bAnimationOnFrameClock = FALSE;
+			pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
+		}
 	}
 }
 
+void cairo_dock_launch_animation (GldiContainer *pContainer)
+{
+	if (CAIRO_DOCK_IS_DOCK (pContainer))  // we don't know who wants to be animated, so let the loop find them.
+		CAIRO_DOCK (pContainer)->bUpdateAllIcons = TRUE;
+	_launch_animation_loop (pContainer);
+}
+
+void cairo_dock_stop_animation (GldiContainer *pContainer)
+{
+	if (pContainer->iSidGLAnimation == 0)
+		return;
+	if (pContainer->bAnimationOnFrameClock)
+	{
+		if (pContainer->pWidget != NULL)  // else the tick callback has been removed along with the widget
+			gtk_widget_remove_tick_callback (pContainer->pWidget, pContainer->iSidGLAnimation);
+	}
+	else
+		g_source_remove (pContainer->iSidGLAnimation);
+	pContainer->iSidGLAnimation = 0;
+}
+
+void cairo_dock_add_animated_icon (CairoDock *pDock, Icon *pIcon)
+{
+	if (pDock->pAnimatedIcons == NULL)
+		pDock->pAnimatedIcons = g_hash_table_new (NULL, NULL);
+	g_hash_table_add (pDock->pAnimatedIcons, pIcon);
+}
+
+void cairo_dock_remove_animated_icon (CairoDock *pDock, Icon *pIcon)
+{
+	if (pDock->pAnimatedIcons != NULL)
+		g_hash_table_remove (pDock->pAnimatedIcons, pIcon);
+}
+
 void cairo_dock_start_shrinking (CairoDock *pDock)
 {
 	if (! pDock->bIsShrinkingDown)  // on lance l'animation.
@@ -248,7 +303,8 @@ void gldi_icon_start_animation (Icon *pIcon)
 		(cairo_dock_icon_is_being_inserted_or_removed (pIcon) || pIcon->bIsDemandingAttention || pIcon->bAlwaysVisible || cairo_dock_animation_will_be_visible (pDock)))
 	{
 		//g_print ("  c'est parti\n");
-		cairo_dock_launch_animation (CAIRO_CONTAINER (pDock));
+		cairo_dock_add_animated_icon (pDock, pIcon);
+		_launch_animation_loop (CAIRO_CONTAINER (pDock));
 	}
 }
 
@@ -369,6 +425,9 @@ void cairo_dock_mark_icon_animation_as (Icon *pIcon, CairoDockAnimationState iAn
 	{
 		pIcon->iAnimationState = iAnimationState;
 	}
+	GldiContainer *pContainer = cairo_dock_get_icon_container (pIcon);
+	if (pContainer != NULL && CAIRO_DOCK_IS_DOCK (pContainer))  // the animation loop of the dock will update it from now on
+		cairo_dock_add_animated_icon (CAIRO_DOCK (pContainer), pIcon);
 }
 void cairo_dock_stop_marking_icon_animation_as (Icon *pIcon, CairoDockAnimationState iAnimationState)
 {
@@ -455,7 +514,13 @@ void cairo_dock_set_transition_on_icon (Icon *pIcon, GldiContainer *pContainer,
 		(GldiNotificationFunc) _cairo_dock_transition_step,
 		GLDI_RUN_AFTER, pUserData);
 	
-	cairo_dock_launch_animation (pContainer);
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+	{
+		cairo_dock_add_animated_icon (CAIRO_DOCK (pContainer), pIcon);
+		_launch_animation_loop (pContainer);
+	}
+	else
+		cairo_dock_launch_animation (pContainer);
 }
 
 void cairo_dock_remove_transition_on_icon (Icon *pIcon)
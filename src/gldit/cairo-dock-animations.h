@@ -110,11 +110,28 @@ void cairo_dock_pop_down (CairoDock *pDock);
 
 gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 
-/** Launch the animation of a Container.
+/** Launch the animation of a Container. For a Dock, all its icons are updated on the next iteration, and the ones that are animated are updated on the following iterations; if you know which icon is animated, use \ref gldi_icon_start_animation instead.
 *@param pContainer the container to animate.
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Stop the animation loop of a Container, whatever drives it.
+*@param pContainer the container.
+*/
+void cairo_dock_stop_animation (GldiContainer *pContainer);
+
+/** Add an Icon to the set of icons updated by the animation loop of a Dock. This is done by \ref gldi_icon_start_animation and \ref cairo_dock_mark_icon_animation_as; the icon leaves the set as soon as it is not animated any more.
+*@param pDock the dock containing the icon.
+*@param pIcon the icon.
+*/
+void cairo_dock_add_animated_icon (CairoDock *pDock, Icon *pIcon);
+
+/** Remove an Icon from the set of animated icons of a Dock, for instance because it is detached from it.
+*@param pDock the dock.
+*@param pIcon the icon.
+*/
+void cairo_dock_remove_animated_icon (CairoDock *pDock, Icon *pIcon);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
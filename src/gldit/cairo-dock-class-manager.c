@@ -59,6 +59,14 @@ extern CairoDockDesktopEnv g_iDesktopEnv;
 
 static GHashTable *s_hClassTable = NULL;
 static GHashTable *s_hAltClass = NULL; // we store alternative class / app-ids here
+static GHashTable *s_hPrefetchedDesktopFiles = NULL;  // desktop files parsed beforehand (path -> key file)
+
+// results of the class guessing and of the desktop files search; negative results are cached too.
+#define CAIRO_DOCK_CLASS_CACHE_MAX_SIZE 512
+static GHashTable *s_hGuessedClasses = NULL;  // "command\nStartupWMClass" -> class
+static GHashTable *s_hDesktopFilePaths = NULL;  // lowercase desktop file ID -> path
+static guint s_iCacheGeneration = 0;  // generation of the desktop files DB the caches were filled with
+static GThread *s_pMainThread = NULL;  // the caches are only used from the main thread (the desktop files DB guesses classes in its own thread)
 
 
 static void cairo_dock_free_class_appli (CairoDockClassAppli *pClassAppli)
@@ -109,6 +117,7 @@ static gboolean _on_window_activated (G_GNUC_UNUSED gpointer data, GldiWindowAct
 void cairo_dock_initialize_class_manager (void)
 {
 	gldi_desktop_file_db_init ();
+	s_pMainThread = g_thread_self ();
 	if (s_hClassTable == NULL)
 		s_hClassTable = g_hash_table_new_full (g_str_hash,
 			g_str_equal,
@@ -626,11 +635,26 @@ void cairo_dock_remove_all_applis_from_class_table (void)  // for the stop_appli
 	g_hash_table_foreach (s_hClassTable, (GHFunc) _cairo_dock_remove_all_applis_from_class, NULL);
 }
 
+static void _clear_class_caches (void)
+{
+	if (s_hGuessedClasses != NULL)
+	{
+		g_hash_table_destroy (s_hGuessedClasses);
+		s_hGuessedClasses = NULL;
+	}
+	if (s_hDesktopFilePaths != NULL)
+	{
+		g_hash_table_destroy (s_hDesktopFilePaths);
+		s_hDesktopFilePaths = NULL;
+	}
+}
+
 void cairo_dock_reset_class_table (void)
 {
 	g_hash_table_remove_all (s_hClassTable);
 	g_hash_table_remove_all (s_hAltClass);
 	gldi_desktop_file_db_stop ();
+	_clear_class_caches ();
 }
 
 
@@ -1611,23 +1635,26 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 }
 
 
-static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or even class
+// get a cache of results, or NULL if it can't be used; the caches are emptied when the desktop files DB has been updated, or when they are full.
+static GHashTable *_get_class_cache (GHashTable **pCache)
 {
-	if (cDesktopFile == NULL)
+	if (g_thread_self () != s_pMainThread)
 		return NULL;
-	if (*cDesktopFile == '/') 
+	guint iGeneration = gldi_desktop_file_db_get_generation ();
+	if (iGeneration != s_iCacheGeneration)
 	{
-		if (g_file_test (cDesktopFile, G_FILE_TEST_EXISTS))  // it's a path and it exists.
-			return g_strdup (cDesktopFile);
-		return NULL; // if we got an absolute path, we require it to be correct
+		_clear_class_caches ();
+		s_iCacheGeneration = iGeneration;
 	}
+	if (*pCache == NULL)
+		*pCache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	else if (g_hash_table_size (*pCache) >= CAIRO_DOCK_CLASS_CACHE_MAX_SIZE)
+		g_hash_table_remove_all (*pCache);
+	return *pCache;
+}
 
-	// note: cDesktopFile will already be lowercase if it is an app-id / class
-	gchar *cDesktopFileName = g_ascii_strdown (cDesktopFile, -1);
-	// remove the .desktop suffix if it is present
-	gchar *tmp = g_strrstr (cDesktopFileName, ".desktop");
-	if (tmp) *tmp = 0;
-	
+static gchar *_search_desktop_file_in_db (const gchar *cDesktopFileName)
+{
 	// normal case: we have the correct name
 	const gchar *res = gldi_desktop_file_db_lookup (cDesktopFileName);
 	
@@ -1667,11 +1694,44 @@ static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or
 		g_string_free(sID, TRUE);
 	}
 	
-	g_free (cDesktopFileName);
 	return res ? g_strdup (res) : NULL;
 }
 
-gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMClass)
+static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or even class
+{
+	if (cDesktopFile == NULL)
+		return NULL;
+	if (*cDesktopFile == '/') 
+	{
+		if (g_file_test (cDesktopFile, G_FILE_TEST_EXISTS))  // it's a path and it exists.
+			return g_strdup (cDesktopFile);
+		return NULL; // if we got an absolute path, we require it to be correct
+	}
+
+	// note: cDesktopFile will already be lowercase if it is an app-id / class
+	gchar *cDesktopFileName = g_ascii_strdown (cDesktopFile, -1);
+	// remove the .desktop suffix if it is present
+	gchar *tmp = g_strrstr (cDesktopFileName, ".desktop");
+	if (tmp) *tmp = 0;
+	
+	// windows of the same app come with the same ID, so the result is likely to be known already
+	GHashTable *pCache = _get_class_cache (&s_hDesktopFilePaths);
+	gchar *cPath = NULL;
+	if (pCache != NULL && g_hash_table_lookup_extended (pCache, cDesktopFileName, NULL, (gpointer*)&cPath))
+	{
+		g_free (cDesktopFileName);
+		return g_strdup (cPath);
+	}
+	
+	cPath = _search_desktop_file_in_db (cDesktopFileName);
+	if (pCache != NULL)
+		g_hash_table_insert (pCache, cDesktopFileName, g_strdup (cPath));
+	else
+		g_free (cDesktopFileName);
+	return cPath;
+}
+
+static gchar *_guess_class (const gchar *cCommand, const gchar *cStartupWMClass)
 {
 	// Several cases are possible:
 	// Exec=toto
@@ -1848,6 +1908,26 @@ gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMCla
 	return cResult;
 }
 
+gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMClass)
+{
+	GHashTable *pCache = _get_class_cache (&s_hGuessedClasses);
+	if (pCache == NULL)
+		return _guess_class (cCommand, cStartupWMClass);
+	
+	// a NULL and an empty string are handled the same way
+	gchar *cKey = g_strconcat (cCommand ? cCommand : "", "\n", cStartupWMClass ? cStartupWMClass : "", NULL);
+	gchar *cClass = NULL;
+	if (g_hash_table_lookup_extended (pCache, cKey, NULL, (gpointer*)&cClass))
+	{
+		g_free (cKey);
+		return g_strdup (cClass);
+	}
+	
+	cClass = _guess_class (cCommand, cStartupWMClass);
+	g_hash_table_insert (pCache, cKey, g_strdup (cClass));
+	return cClass;
+}
+
 static void _add_action_menus (GKeyFile *pKeyFile, CairoDockClassAppli *pClassAppli, const gchar *cGettextDomain, const gchar *cMenuListKey, const gchar *cMenuGroup, gboolean bActionFirstInGroupKey)
 {
 	gsize length = 0;
@@ -1891,6 +1971,36 @@ static void _add_action_menus (GKeyFile *pKeyFile, CairoDockClassAppli *pClassAp
 	}
 }
 
+void cairo_dock_prefetch_class_desktop_file (const gchar *cDesktopFilePath, GKeyFile *pKeyFile)
+{
+	if (s_hPrefetchedDesktopFiles == NULL)
+		s_hPrefetchedDesktopFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_key_file_free);
+	g_hash_table_insert (s_hPrefetchedDesktopFiles, g_strdup (cDesktopFilePath), pKeyFile);
+}
+
+void cairo_dock_clear_prefetched_class_desktop_files (void)
+{
+	if (s_hPrefetchedDesktopFiles != NULL)
+	{
+		g_hash_table_destroy (s_hPrefetchedDesktopFiles);
+		s_hPrefetchedDesktopFiles = NULL;
+	}
+}
+
+static GKeyFile *_open_class_desktop_file (const gchar *cDesktopFilePath)
+{
+	gchar *cKey = NULL;
+	GKeyFile *pKeyFile = NULL;
+	if (s_hPrefetchedDesktopFiles != NULL
+	&& g_hash_table_lookup_extended (s_hPrefetchedDesktopFiles, cDesktopFilePath, (gpointer*)&cKey, (gpointer*)&pKeyFile))
+	{
+		g_hash_table_steal (s_hPrefetchedDesktopFiles, cDesktopFilePath);  // the caller takes the key file
+		g_free (cKey);
+		return pKeyFile;
+	}
+	return cairo_dock_open_key_file (cDesktopFilePath);
+}
+
 /*
 register from desktop-file name/path (+class-name):
   if class-name: guess class -> lookup class -> if already registered => quit
@@ -1964,7 +2074,7 @@ gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *c
 
 	//\__________________ open it.
 	cd_debug ("+ parsing class desktop file %s...", cDesktopFilePath);
-	GKeyFile* pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	GKeyFile* pKeyFile = _open_class_desktop_file (cDesktopFilePath);
 	g_return_val_if_fail (pKeyFile != NULL, NULL);
 
 	//\__________________ guess the class name.
@@ -2123,6 +2233,7 @@ gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *c
 		//g_print ("%s ----> %s\n", cClass, pClassAppli->cStartupWMClass);
 		g_free (cDesktopFilePath);
 		g_free (cCommand);
+		g_key_file_free (pKeyFile);
 		return cClass;
 	}
 	pClassAppli->bSearchedAttributes = TRUE;
@@ -215,6 +215,16 @@ gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMCla
 
 gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *cClassName, const gchar *cWmClass);
 
+/** Provide the content of a desktop file that is about to be registered, so that it doesn't have to be read again. It allows to parse the desktop files in other threads beforehand.
+* @param cDesktopFilePath path of the desktop file
+* @param pKeyFile its content; it's taken by the function.
+*/
+void cairo_dock_prefetch_class_desktop_file (const gchar *cDesktopFilePath, GKeyFile *pKeyFile);
+
+/** Forget the desktop files that have been provided with \ref cairo_dock_prefetch_class_desktop_file and not used.
+*/
+void cairo_dock_clear_prefetched_class_desktop_files (void);
+
 /** Register a class corresponding to a desktop file. Launchers can then derive from the class.
 * @param cDesktopFile the desktop file path or name; if it's a name or if the path couldn't be found, it will be searched in the common directories.
 * @return the class ID in a newly allocated string.
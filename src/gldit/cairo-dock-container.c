@@ -172,11 +172,11 @@ void cairo_dock_redraw_container (GldiContainer *pContainer)
 	cairo_dock_redraw_container_area (pContainer, &rect);
 }
 
-static inline void _redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea)
+static inline gboolean _redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea)
 {
-	g_return_if_fail (pContainer != NULL);
+	g_return_val_if_fail (pContainer != NULL, FALSE);
 	if (! gldi_container_is_visible (pContainer))
-		return ;
+		return FALSE;
 	
 	if (pArea->y < 0)
 		pArea->y = 0;
@@ -186,13 +186,21 @@ static inline void _redraw_container_area (GldiContainer *pContainer, GdkRectang
 		pArea->width = pContainer->iHeight - pArea->x;
 	
 	if (pArea->width > 0 && pArea->height > 0)
+	{
 		gdk_window_invalidate_rect (gldi_container_get_gdk_window (pContainer), pArea, FALSE);
+		return TRUE;
+	}
+	return FALSE;
 }
 
 void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea)
 {
-	if (CAIRO_DOCK_IS_DOCK (pContainer) && ! cairo_dock_animation_will_be_visible (CAIRO_DOCK (pContainer)))  // inutile de redessiner.
-		return ;
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+	{
+		if (! cairo_dock_animation_will_be_visible (CAIRO_DOCK (pContainer)))  // inutile de redessiner.
+			return ;
+		CAIRO_DOCK (pContainer)->bDamagedEntirely = TRUE;  // we don't know what is in this area, so the dock will be fully rendered.
+	}
 	_redraw_container_area (pContainer, pArea);
 }
 
@@ -208,7 +216,18 @@ void cairo_dock_redraw_icon (Icon *icon)
 		( (cairo_dock_is_hidden (CAIRO_DOCK (pContainer)) && ! icon->bIsDemandingAttention && ! icon->bAlwaysVisible)
 		|| (CAIRO_DOCK (pContainer)->iRefCount != 0 && ! gldi_container_is_visible (pContainer)) ) )  // inutile de redessiner.
 		return ;
-	_redraw_container_area (pContainer, &rect);
+	if (_redraw_container_area (pContainer, &rect) && CAIRO_DOCK_IS_DOCK (pContainer))
+	{
+		// accumulate the damage until the next frame, so that only the damaged icons are rendered then.
+		CairoDock *pDock = CAIRO_DOCK (pContainer);
+		if (! pDock->bDamagedEntirely)
+		{
+			if (pDock->pDamagedArea == NULL)
+				pDock->pDamagedArea = cairo_region_create_rectangle (&rect);
+			else
+				cairo_region_union_rectangle (pDock->pDamagedArea, &rect);
+		}
+	}
 }
 
 
@@ -831,11 +850,7 @@ static void reset_object (GldiObject *obj)
 	pContainer->pWidget = NULL;
 	
 	// stop the animation loop
-	if (pContainer->iSidGLAnimation != 0)
-	{
-		g_source_remove (pContainer->iSidGLAnimation);
-		pContainer->iSidGLAnimation = 0;
-	}
+	cairo_dock_stop_animation (pContainer);
 	
 	if (g_pPrimaryContainer == pContainer)
 		g_pPrimaryContainer = NULL;
@@ -165,6 +165,10 @@ struct _GldiContainer {
 	void *pMoveToRect;
 	/// a wl_egl_window (needed on Wayland + EGL)
 	void *eglwindow;
+	/// TRUE if the animation loop follows the frame clock of the window, in which case iSidGLAnimation is the ID of a tick callback.
+	gboolean bAnimationOnFrameClock;
+	/// frame time of the last step of the animation loop, when it follows the frame clock.
+	gint64 iLastAnimationStepTime;
 	
 	gpointer reserved[2];
 };
@@ -402,7 +406,7 @@ void cairo_dock_redraw_container (GldiContainer *pContainer);
 */
 void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea);
 
-/** Clear and trigger the redraw of an Icon. The drawing is not done immediately, but when the expose event is received.
+/** Clear and trigger the redraw of an Icon. The drawing is not done immediately, but when the expose event is received. In a dock, the areas of the icons redrawn during a frame are accumulated, and if nothing else has to be redrawn, only these areas are rendered.
 *@param icon l'icone a retracer.
 */
 void cairo_dock_redraw_icon (Icon *icon);
@@ -53,8 +53,10 @@
 #include "cairo-dock-icon-container.h"
 #include "cairo-dock-utils.h"  // cairo_dock_get_version_from_string
 #include "cairo-dock-file-manager.h"
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_sync_all_keyfiles
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-log.h"
+#include "cairo-dock-profiler.h"
 #include "cairo-dock-opengl.h"
 #include "cairo-dock-core.h"
 
@@ -107,6 +109,8 @@ void gldi_init (GldiRenderingMethod iRendering)
 	
 	cairo_dock_get_version_from_string (GLDI_VERSION, &g_iMajorVersion, &g_iMinorVersion, &g_iMicroVersion);
 	
+	gldi_profiler_init ();
+	
 	// register all managers
 	_gldi_register_core_managers ();
 	
@@ -130,6 +134,8 @@ void gldi_init (GldiRenderingMethod iRendering)
 
 void gldi_free_all (void)
 {
+	cairo_dock_sync_all_keyfiles ();  // write the changes that are still pending.
+	
 	if (g_pPrimaryContainer == NULL)
 		return ;
 	
@@ -55,13 +55,8 @@ static void _cairo_dock_init_data_renderer (CairoDataRenderer *pRenderer, CairoD
 	pRenderer->data.iNbValues = MAX (1, pAttribute->iNbValues);
 	pRenderer->data.iMemorySize = MAX (2, pAttribute->iMemorySize);  // au moins la derniere valeur et la nouvelle.
 	pRenderer->data.pValuesBuffer = g_new0 (gdouble, pRenderer->data.iNbValues * pRenderer->data.iMemorySize);
-	pRenderer->data.pTabValues = g_new (gdouble *, pRenderer->data.iMemorySize);
-	int i;
-	for (i = 0; i < pRenderer->data.iMemorySize; i ++)
-	{
-		pRenderer->data.pTabValues[i] = &pRenderer->data.pValuesBuffer[i*pRenderer->data.iNbValues];
-	}
 	pRenderer->data.iCurrentIndex = -1;
+	int i;
 	pRenderer->data.pMinMaxValues = g_new (gdouble, 2 * pRenderer->data.iNbValues);
 	if (pAttribute->pMinMaxValues != NULL)
 	{
@@ -541,6 +536,30 @@ static void _cairo_dock_finish_load_data_renderer (CairoDataRenderer *pRenderer,
 	}
 }
 
+static void _resize_history (CairoDataToRenderer *pData, int iNewMemorySize)
+{
+	int iOldMemorySize = pData->iMemorySize;
+	gdouble *pOldBuffer = pData->pValuesBuffer;
+	pData->iMemorySize = iNewMemorySize;
+	pData->pValuesBuffer = g_new0 (gdouble, pData->iNbValues * iNewMemorySize);
+	if (pData->iCurrentIndex >= 0)  // keep the most recent values; they are put at the beginning of the new ring buffers, from the oldest to the current one.
+	{
+		int n = MIN (iOldMemorySize, iNewMemorySize);
+		int iFirst = pData->iCurrentIndex - (n - 1) + iOldMemorySize;
+		gdouble *pOldHistory, *pNewHistory;
+		int i, t;
+		for (i = 0; i < pData->iNbValues; i ++)
+		{
+			pOldHistory = &pOldBuffer[i * iOldMemorySize];
+			pNewHistory = &pData->pValuesBuffer[i * iNewMemorySize];
+			for (t = 0; t < n; t ++)
+				pNewHistory[t] = pOldHistory[(iFirst + t) % iOldMemorySize];
+		}
+		pData->iCurrentIndex = n - 1;
+	}
+	g_free (pOldBuffer);
+}
+
 void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pContainer, CairoDataRendererAttribute *pAttribute)
 {
 	//\___________________ if a previous renderer exists, keep its data alive.
@@ -558,25 +577,7 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 			
 			pAttribute->iMemorySize = MAX (2, pAttribute->iMemorySize);
 			if (pData->iMemorySize != pAttribute->iMemorySize)  // on redimensionne le tampon des valeurs.
-			{
-				int iOldMemorySize = pData->iMemorySize;
-				pData->iMemorySize = pAttribute->iMemorySize;
-				pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-				if (pData->iMemorySize > iOldMemorySize)
-				{
-					memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (pData->iMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-				}
-				
-				g_free (pData->pTabValues);
-				pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-				int i;
-				for (i = 0; i < pData->iMemorySize; i ++)
-				{
-					pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-				}
-				if (pData->iCurrentIndex >= pData->iMemorySize)
-					pData->iCurrentIndex = pData->iMemorySize - 1;
-			}
+				_resize_history (pData, pAttribute->iMemorySize);
 		}
 		
 		//\_____________ remove the current data-renderer
@@ -641,31 +642,49 @@ static gboolean _render_delayed (Icon *pIcon)
 	pRenderer->iSidRenderIdle = 0;
 	return FALSE;
 }
-void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues)
+static void _add_samples (CairoDataRenderer *pRenderer, const double *pNewValues, int iNbSamples)
 {
-	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
-	g_return_if_fail (pRenderer != NULL);
-	
-	//\___________________ On met a jour les valeurs du renderer.
+	if (iNbSamples <= 0)
+		return;
 	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
-	pData->iCurrentIndex ++;
-	if (pData->iCurrentIndex >= pData->iMemorySize)
-		pData->iCurrentIndex -= pData->iMemorySize;
+	int iNbValues = pData->iNbValues, iMemorySize = pData->iMemorySize;
+	int iFirst = MAX (0, iNbSamples - iMemorySize);  // older samples would be overwritten anyway, they only count for the range.
+	gdouble *pHistory, *pMinMax;
 	double fNewValue;
-	int i;
-	for (i = 0; i < pData->iNbValues; i ++)
+	int i, n, iIndex;
+	for (i = 0; i < iNbValues; i ++)
 	{
-		fNewValue = pNewValues[i];
-		if (pRenderer->bUpdateMinMax && fNewValue > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+		pHistory = &pData->pValuesBuffer[i * iMemorySize];
+		pMinMax = &pData->pMinMaxValues[2*i];
+		iIndex = pData->iCurrentIndex;
+		for (n = 0; n < iNbSamples; n ++)
 		{
-			if (fNewValue < pData->pMinMaxValues[2*i])
-				pData->pMinMaxValues[2*i] = fNewValue;
-			if (fNewValue > pData->pMinMaxValues[2*i+1])
-				pData->pMinMaxValues[2*i+1] = MAX (fNewValue, pData->pMinMaxValues[2*i]+.1);
+			fNewValue = pNewValues[n * iNbValues + i];
+			if (pRenderer->bUpdateMinMax && fNewValue > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+			{
+				if (fNewValue < pMinMax[0])
+					pMinMax[0] = fNewValue;
+				if (fNewValue > pMinMax[1])
+					pMinMax[1] = MAX (fNewValue, pMinMax[0]+.1);
+			}
+			if (n >= iFirst)
+			{
+				iIndex ++;
+				if (iIndex == iMemorySize)
+					iIndex = 0;
+				pHistory[iIndex] = fNewValue;
+			}
 		}
-		pData->pTabValues[pData->iCurrentIndex][i] = fNewValue;
 	}
+	pData->iCurrentIndex = (pData->iCurrentIndex + iNbSamples - iFirst) % iMemorySize;
+	pData->iNbAddedSamples += iNbSamples;
 	pData->bHasValue = TRUE;
+}
+
+static void _render_new_data (CairoDataRenderer *pRenderer, Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext)
+{
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int i;
 	
 	//\___________________ On met a jour le dessin de l'icone.
 	if (CAIRO_DOCK_CONTAINER_IS_OPENGL (pContainer) && pRenderer->interface.render_opengl)
@@ -720,6 +739,84 @@ void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer,
 	cairo_dock_redraw_icon (pIcon);
 }
 
+void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues)
+{
+	cairo_dock_render_new_samples_on_icon (pIcon, pContainer, pCairoContext, pNewValues, 1);
+}
+
+void cairo_dock_render_new_samples_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, const double *pNewValues, int iNbSamples)
+{
+	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
+	g_return_if_fail (pRenderer != NULL);
+	
+	//\___________________ On met a jour les valeurs du renderer.
+	_add_samples (pRenderer, pNewValues, iNbSamples);
+	
+	//\___________________ On met a jour le dessin de l'icone.
+	_render_new_data (pRenderer, pIcon, pContainer, pCairoContext);
+}
+
+
+CairoDataRendererQueue *cairo_data_renderer_queue_new (int iNbValues, int iNbSamples)
+{
+	CairoDataRendererQueue *pQueue = g_new0 (CairoDataRendererQueue, 1);
+	pQueue->iNbValues = MAX (1, iNbValues);
+	pQueue->iSize = MAX (1, iNbSamples) + 1;  // 1 slot is always left empty, to tell a full queue from an empty one.
+	pQueue->pSamples = g_new0 (gdouble, pQueue->iNbValues * pQueue->iSize);
+	return pQueue;
+}
+
+void cairo_data_renderer_queue_free (CairoDataRendererQueue *pQueue)
+{
+	if (pQueue == NULL)
+		return;
+	g_free (pQueue->pSamples);
+	g_free (pQueue);
+}
+
+int cairo_data_renderer_queue_push (CairoDataRendererQueue *pQueue, const double *pNewValues, int iNbSamples)
+{
+	g_return_val_if_fail (pQueue != NULL, 0);
+	int iTail = pQueue->iTail;  // only the writer modifies it.
+	int iHead = g_atomic_int_get (&pQueue->iHead);
+	int iNbFreeSlots = (iHead - iTail - 1 + pQueue->iSize) % pQueue->iSize;
+	int n, iNbPushed = MIN (iNbSamples, iNbFreeSlots);
+	for (n = 0; n < iNbPushed; n ++)
+	{
+		memcpy (&pQueue->pSamples[iTail * pQueue->iNbValues], &pNewValues[n * pQueue->iNbValues], pQueue->iNbValues * sizeof (gdouble));
+		iTail ++;
+		if (iTail == pQueue->iSize)
+			iTail = 0;
+	}
+	g_atomic_int_set (&pQueue->iTail, iTail);  // publish the samples once they are fully written.
+	return iNbPushed;
+}
+
+void cairo_dock_render_queued_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, CairoDataRendererQueue *pQueue)
+{
+	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
+	g_return_if_fail (pRenderer != NULL && pQueue != NULL && pQueue->iNbValues == cairo_data_renderer_get_nb_values (pRenderer));
+	
+	//\___________________ take all the samples published so far.
+	int iHead = pQueue->iHead;  // only the reader modifies it.
+	int iTail = g_atomic_int_get (&pQueue->iTail);
+	if (iHead == iTail)  // nothing new
+		return;
+	if (iHead < iTail)
+	{
+		_add_samples (pRenderer, &pQueue->pSamples[iHead * pQueue->iNbValues], iTail - iHead);
+	}
+	else  // the samples wrap around the end of the queue.
+	{
+		_add_samples (pRenderer, &pQueue->pSamples[iHead * pQueue->iNbValues], pQueue->iSize - iHead);
+		_add_samples (pRenderer, pQueue->pSamples, iTail);
+	}
+	g_atomic_int_set (&pQueue->iHead, iTail);  // the slots can be reused by the writer.
+	
+	//\___________________ and draw them in 1 go.
+	_render_new_data (pRenderer, pIcon, pContainer, pCairoContext);
+}
+
 
 
 void cairo_dock_free_data_renderer (CairoDataRenderer *pRenderer)
@@ -734,7 +831,6 @@ void cairo_dock_free_data_renderer (CairoDataRenderer *pRenderer)
 		pRenderer->interface.unload (pRenderer);
 	
 	g_free (pRenderer->data.pValuesBuffer);
-	g_free (pRenderer->data.pTabValues);
 	g_free (pRenderer->data.pMinMaxValues);
 	
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
@@ -822,23 +918,7 @@ void cairo_dock_resize_data_renderer_history (Icon *pIcon, int iNewMemorySize)
 	if (pData->iMemorySize == iNewMemorySize)
 		return ;
 	
-	int iOldMemorySize = pData->iMemorySize;
-	pData->iMemorySize = iNewMemorySize;
-	pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-	if (iNewMemorySize > iOldMemorySize)
-	{
-		memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (iNewMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-	}
-	
-	g_free (pData->pTabValues);
-	pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-	int i;
-	for (i = 0; i < pData->iMemorySize; i ++)
-	{
-		pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-	}
-	if (pData->iCurrentIndex >= pData->iMemorySize)
-		pData->iCurrentIndex = pData->iMemorySize - 1;
+	_resize_history (pData, iNewMemorySize);
 }
 
 void cairo_dock_refresh_data_renderer (Icon *pIcon, GldiContainer *pContainer)
@@ -57,11 +57,25 @@ typedef enum _RendererRotateTheme {
 struct _CairoDataToRenderer {
 	gint iNbValues;
 	gint iMemorySize;
-	gdouble *pValuesBuffer;
-	gdouble **pTabValues;
+	gdouble *pValuesBuffer;  // history of each value, one after the other: the history of the i-th value is the ring buffer of iMemorySize values starting at pValuesBuffer[i*iMemorySize].
 	gdouble *pMinMaxValues;
-	gint iCurrentIndex;
+	gint iCurrentIndex;  // index of the current value in the ring buffers.
 	gboolean bHasValue;  // TRUE as soon as a value has been set in the history
+	guint iNbAddedSamples;  // number of sets of values added so far; renderers can compare it with a previous count to know how many values are new.
+};
+
+/// A queue of new values waiting to be added to the history of a Data Renderer. It lets a thread (typically the asynchronous part of a Task) feed a Data Renderer without any lock, as long as there is only 1 thread pushing values; the values are then rendered in 1 go from the main thread with \ref cairo_dock_render_queued_data_on_icon.
+struct _CairoDataRendererQueue {
+	// number of values of each sample.
+	gint iNbValues;
+	// number of samples the queue can hold + 1.
+	gint iSize;
+	// the samples, each one being iNbValues consecutive values.
+	gdouble *pSamples;
+	// index of the next sample to be read, only modified by the reader.
+	gint iHead;
+	// index of the next sample to be written, only modified by the writer.
+	gint iTail;
 };
 
 #define CAIRO_DOCK_DATA_FORMAT_MAX_LEN 20
@@ -220,6 +234,38 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 *@param pNewValues a set a new values (must be of the size defined on the creation of the Renderer)*/
 void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues);
 
+/**Add several sets of new values to the history of the Renderer, and draw the icon once. It is equivalent to calling \ref cairo_dock_render_new_data_on_icon for each set of values, but much lighter.
+*@param pIcon the icon
+*@param pContainer the icon's container
+*@param pCairoContext a drawing context on the icon
+*@param pNewValues the sets of values, one after the other (iNbSamples * the number of values defined on the creation of the Renderer)
+*@param iNbSamples number of sets of values*/
+void cairo_dock_render_new_samples_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, const double *pNewValues, int iNbSamples);
+
+/**Create a queue to feed a Data Renderer from another thread.
+*@param iNbValues number of values of each set (must be the number of values defined on the creation of the Renderer)
+*@param iNbSamples maximum number of sets of values the queue can hold before they are rendered
+*@return the new queue, to be freed with \ref cairo_data_renderer_queue_free*/
+CairoDataRendererQueue *cairo_data_renderer_queue_new (int iNbValues, int iNbSamples);
+
+/**Destroy a queue. Nobody must be using it anymore.
+*@param pQueue the queue*/
+void cairo_data_renderer_queue_free (CairoDataRendererQueue *pQueue);
+
+/**Push new sets of values into a queue. It doesn't take any lock, so it can be called from any thread, provided that only 1 thread pushes values into a given queue.
+*@param pQueue the queue
+*@param pNewValues the sets of values, one after the other
+*@param iNbSamples number of sets of values
+*@return the number of sets of values actually pushed; it is smaller than iNbSamples if the queue is full.*/
+int cairo_data_renderer_queue_push (CairoDataRendererQueue *pQueue, const double *pNewValues, int iNbSamples);
+
+/**Add all the values waiting in a queue to the history of the Renderer, and draw the icon once. It must be called from the main thread (for instance in the 'update' function of a Task).
+*@param pIcon the icon
+*@param pContainer the icon's container
+*@param pCairoContext a drawing context on the icon
+*@param pQueue the queue*/
+void cairo_dock_render_queued_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, CairoDataRendererQueue *pQueue);
+
 /**Remove the Data Renderer of an icon. All the allocated ressources will be freed.
 *@param pIcon the icon*/
 void cairo_dock_remove_data_renderer_on_icon (Icon *pIcon);
@@ -272,6 +318,16 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 
 #define cairo_data_renderer_get_history_size(pRenderer) ((pRenderer)->data.iMemorySize)
 
+/**Get the history of the i-th value, as a ring buffer of \ref cairo_data_renderer_get_history_size values, the current value being at the index returned by \ref cairo_data_renderer_get_current_index. It is useful to go through the history without computing an index for each value.
+*@param pRenderer a data renderer
+*@param i the number of the value
+*@return an array of double */
+#define cairo_data_renderer_get_history(pRenderer, i) (&(pRenderer)->data.pValuesBuffer[(i) * (pRenderer)->data.iMemorySize])
+/**Get the index of the current value in the history.
+*@param pRenderer a data renderer
+*@return an index in the history, or -1 if there is no value yet */
+#define cairo_data_renderer_get_current_index(pRenderer) ((pRenderer)->data.iCurrentIndex)
+
 #define cairo_data_renderer_get_nth_label(pRenderer, i) (&(pRenderer)->pLabels[i])
 #define cairo_data_renderer_get_nth_value_text(pRenderer, i) (&(pRenderer)->pValuesText[i])
 #define cairo_data_renderer_get_nth_emblem(pRenderer, i) (&(pRenderer)->pEmblems[i])
@@ -298,12 +354,12 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 *@param i the number of the value
 *@param t the time (in number of steps)
 *@return a double*/
-#define cairo_data_renderer_get_value(pRenderer, i, t) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex+t > pRenderer->data.iMemorySize ? pRenderer->data.iCurrentIndex+t-pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t < 0 ? pRenderer->data.iCurrentIndex+t+pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t][i]
+#define cairo_data_renderer_get_value(pRenderer, i, t) cairo_data_renderer_get_history (pRenderer, i)[((pRenderer)->data.iCurrentIndex + (t) + (pRenderer)->data.iMemorySize) % (pRenderer)->data.iMemorySize]
 /**Get the current i-th value.
 *@param pRenderer a data renderer
 *@param i the number of the value
 *@return a double*/
-#define cairo_data_renderer_get_current_value(pRenderer, i) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex][i]
+#define cairo_data_renderer_get_current_value(pRenderer, i) cairo_data_renderer_get_value (pRenderer, i, 0)
 /**Get the previous i-th value.
 *@param pRenderer a data renderer
 *@param i the number of the value
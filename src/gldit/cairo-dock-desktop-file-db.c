@@ -19,6 +19,7 @@
 
 
 #include <glib.h>
+#include <sys/stat.h>  // stat
 #include <string.h>
 #include <gio/gio.h>
 #include <gmodule.h>
@@ -27,6 +28,11 @@
 #include "cairo-dock-class-manager.h" // cairo_dock_guess_class
 #include "cairo-dock-log.h" // cd_error
 
+// The database is saved in an index file, so that it can be used as soon as the dock starts, without waiting for all the desktop files to be parsed.
+// The index records the modification time of each application directory and of each desktop file; the directories whose modification time has not changed don't need to be listed again, and only the files that have been modified are parsed again.
+#define DESKTOP_DB_INDEX_VERSION 2  // 2: times in nanoseconds
+#define DESKTOP_DB_INDEX_TYPE "(ua(ssxasa(sxsss)))"  // version, [dir path, IDs prefix, dir mtime, sub-dirs, [file name, file mtime, ID, file path, alt ID]]
+
 static GAppInfoMonitor *monitor = NULL;
 
 typedef struct _desktop_db {
@@ -34,9 +40,30 @@ typedef struct _desktop_db {
 	GHashTable *alt_class_table; // alternative mapping based on the StartupWMClass (if exists) or command line
 } desktop_db;
 
+typedef struct _desktop_entry {
+	char *name; // name of the file in its directory
+	gint64 mtime; // modification time of the file, in ns
+	char *id; // desktop file ID (lowercase, without the extension), or NULL if the file is not a valid app
+	char *filename; // path of the file, or NULL if the app is hidden (it then hides the apps with the same ID in the next directories)
+	char *alt_id; // class guessed from the StartupWMClass or the command line, or NULL
+} desktop_entry;
+
+typedef struct _desktop_dir {
+	char *path;
+	char *prefix; // prefix of the IDs of its apps ("" for an application directory, "kde4-" for its "kde4" sub-directory, etc)
+	gint64 mtime; // modification time of the directory, in ns: it changes when a file is added, removed or renamed
+	char **subdirs; // names of its sub-directories
+	GPtrArray *entries; // its desktop files
+} desktop_dir;
+
 static desktop_db *db_current = NULL; // current database (used for lookups)
 static desktop_db *db_pending = NULL; // pending database (created by our worker thread)
 
+static guint generation = 1; // incremented each time db_current is replaced
+
+static GPtrArray *dirs = NULL; // indexed directories, in order of precedence; only accessed by the worker thread once it has been started
+static gchar *index_path = NULL; // path of the index file
+
 static GMutex mutex; // mutex for accessing db_pending
 static GCond cond; // condition to signal that db_pending has been updated (only used if db_current == NULL)
 static GThread *thread = NULL; // our worker thread
@@ -56,57 +83,415 @@ static void _desktop_db_free (desktop_db *db)
 	}
 }
 
-static void _process_app (gpointer data, gpointer user_data)
+static void _desktop_entry_free (desktop_entry *entry)
+{
+	if (entry)
+	{
+		g_free (entry->name);
+		g_free (entry->id);
+		g_free (entry->filename);
+		g_free (entry->alt_id);
+		g_free (entry);
+	}
+}
+
+static desktop_dir *_desktop_dir_new (const char *path, const char *prefix, gint64 mtime)
+{
+	desktop_dir *dir = g_new0 (desktop_dir, 1);
+	dir->path = g_strdup (path);
+	dir->prefix = g_strdup (prefix);
+	dir->mtime = mtime;
+	dir->entries = g_ptr_array_new_with_free_func ((GDestroyNotify)_desktop_entry_free);
+	return dir;
+}
+
+static void _desktop_dir_free (desktop_dir *dir)
+{
+	if (dir)
+	{
+		g_free (dir->path);
+		g_free (dir->prefix);
+		g_strfreev (dir->subdirs);
+		g_ptr_array_free (dir->entries, TRUE);
+		g_free (dir);
+	}
+}
+
+// modification time in nanoseconds: with seconds, a change made in the same second as the previous scan would be missed.
+static gint64 _get_mtime (const char *path, gboolean *bIsDir)
+{
+	struct stat st;
+	if (stat (path, &st) != 0)
+		return -1;
+	if (bIsDir)
+		*bIsDir = S_ISDIR (st.st_mode);
+	return (gint64)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+// application directories, in order of precedence (user directory first, as in the XDG specification)
+static GPtrArray *_get_app_dirs (void)
+{
+	GPtrArray *paths = g_ptr_array_new_with_free_func (g_free);
+	g_ptr_array_add (paths, g_build_filename (g_get_user_data_dir (), "applications", NULL));
+	const gchar * const *data_dirs = g_get_system_data_dirs ();
+	int i;
+	guint j;
+	for (i = 0; data_dirs[i] != NULL; i++)
+	{
+		gchar *path = g_build_filename (data_dirs[i], "applications", NULL);
+		for (j = 0; j < paths->len; j ++)  // a directory can be listed several times
+			if (strcmp (path, g_ptr_array_index (paths, j)) == 0)
+				break;
+		if (j < paths->len)
+			g_free (path);
+		else
+			g_ptr_array_add (paths, path);
+	}
+	return paths;
+}
+
+
+  ///////////
+ // INDEX //
+///////////
+
+static GPtrArray *_load_index (void)
 {
-	if (!data) return;
-	desktop_db *db = (desktop_db*)user_data;
-	GAppInfo *app = (GAppInfo*)data;
-	const char *id = g_app_info_get_id (app);
-	if (!id) return;
+	GMappedFile *pMappedFile = g_mapped_file_new (index_path, FALSE, NULL);
+	if (!pMappedFile)
+		return NULL;
+	GBytes *bytes = g_mapped_file_get_bytes (pMappedFile);
+	g_mapped_file_unref (pMappedFile);  // the bytes keep the file mapped
+	GVariant *v = g_variant_new_from_bytes (G_VARIANT_TYPE (DESKTOP_DB_INDEX_TYPE), bytes, FALSE);
+	g_bytes_unref (bytes);
 	
-	GDesktopAppInfo *desktop_app = G_DESKTOP_APP_INFO(app);
-	if (!desktop_app) return;
+	GPtrArray *index = NULL;
+	guint32 version = 0;
+	GVariantIter *dir_iter = NULL;
+	g_variant_get (v, "(ua(ssxasa(sxsss)))", &version, &dir_iter);  // a corrupted index just gives default values
+	if (version == DESKTOP_DB_INDEX_VERSION)
+	{
+		index = g_ptr_array_new_with_free_func ((GDestroyNotify)_desktop_dir_free);
+		const char *path, *prefix, *name, *id, *filename, *alt_id;
+		gint64 mtime, file_mtime;
+		GVariantIter *subdir_iter, *entry_iter;
+		while (g_variant_iter_next (dir_iter, "(&s&sxasa(sxsss))", &path, &prefix, &mtime, &subdir_iter, &entry_iter))
+		{
+			desktop_dir *dir = _desktop_dir_new (path, prefix, mtime);
+			
+			GPtrArray *subdirs = g_ptr_array_new ();
+			while (g_variant_iter_next (subdir_iter, "s", &name))
+				g_ptr_array_add (subdirs, name);  // takes the string
+			g_ptr_array_add (subdirs, NULL);
+			dir->subdirs = (char**)g_ptr_array_free (subdirs, FALSE);
+			
+			while (g_variant_iter_next (entry_iter, "(&sx&s&s&s)", &name, &file_mtime, &id, &filename, &alt_id))
+			{
+				desktop_entry *entry = g_new0 (desktop_entry, 1);
+				entry->name = g_strdup (name);
+				entry->mtime = file_mtime;
+				entry->id = (*id ? g_strdup (id) : NULL);
+				entry->filename = (*filename ? g_strdup (filename) : NULL);
+				entry->alt_id = (*alt_id ? g_strdup (alt_id) : NULL);
+				g_ptr_array_add (dir->entries, entry);
+			}
+			g_variant_iter_free (subdir_iter);
+			g_variant_iter_free (entry_iter);
+			g_ptr_array_add (index, dir);
+		}
+	}
+	g_variant_iter_free (dir_iter);
+	g_variant_unref (v);
+	return index;
+}
+
+static void _save_index (GPtrArray *index)
+{
+	GVariantBuilder builder;
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssxasa(sxsss))"));
+	guint i, j;
+	for (i = 0; i < index->len; i ++)
+	{
+		desktop_dir *dir = g_ptr_array_index (index, i);
+		g_variant_builder_open (&builder, G_VARIANT_TYPE ("(ssxasa(sxsss))"));
+		g_variant_builder_add (&builder, "s", dir->path);
+		g_variant_builder_add (&builder, "s", dir->prefix);
+		g_variant_builder_add (&builder, "x", dir->mtime);
+		g_variant_builder_add_value (&builder, g_variant_new_strv ((const gchar * const *)dir->subdirs, -1));
+		g_variant_builder_open (&builder, G_VARIANT_TYPE ("a(sxsss)"));
+		for (j = 0; j < dir->entries->len; j ++)
+		{
+			desktop_entry *entry = g_ptr_array_index (dir->entries, j);
+			g_variant_builder_add (&builder, "(sxsss)", entry->name, entry->mtime,
+				entry->id ? entry->id : "",
+				entry->filename ? entry->filename : "",
+				entry->alt_id ? entry->alt_id : "");
+		}
+		g_variant_builder_close (&builder);
+		g_variant_builder_close (&builder);
+	}
+	GVariant *v = g_variant_ref_sink (g_variant_new ("(u@a(ssxasa(sxsss)))", DESKTOP_DB_INDEX_VERSION, g_variant_builder_end (&builder)));
 	
-	const char *fn = g_desktop_app_info_get_filename (desktop_app);
-	if (!fn) return;
+	gchar *cDirPath = g_path_get_dirname (index_path);
+	g_mkdir_with_parents (cDirPath, 0700);
+	g_free (cDirPath);
+	GError *erreur = NULL;
+	if (!g_file_set_contents (index_path, g_variant_get_data (v), g_variant_get_size (v), &erreur))  // atomic, so the main thread never maps a partial file
+	{
+		cd_warning ("couldn't save the desktop files index: %s", erreur->message);
+		g_error_free (erreur);
+	}
+	g_variant_unref (v);
+}
+
+// the index is up-to-date if no file has been added or removed in the application directories since it was written (a file modified in place is caught afterwards by the worker thread)
+static gboolean _index_is_valid (GPtrArray *index)
+{
+	guint i, j;
+	for (i = 0; i < index->len; i ++)
+	{
+		desktop_dir *dir = g_ptr_array_index (index, i);
+		if (_get_mtime (dir->path, NULL) != dir->mtime)
+			return FALSE;
+	}
 	
-	const char *wmclass = g_desktop_app_info_get_startup_wm_class (desktop_app);
-	const char *cmdline = g_app_info_get_commandline (app);
+	GPtrArray *paths = _get_app_dirs ();
+	gboolean bValid = TRUE;
+	for (j = 0; j < paths->len && bValid; j ++)
+	{
+		const char *path = g_ptr_array_index (paths, j);
+		for (i = 0; i < index->len; i ++)
+		{
+			desktop_dir *dir = g_ptr_array_index (index, i);
+			if (strcmp (dir->path, path) == 0)
+				break;
+		}
+		if (i == index->len && g_file_test (path, G_FILE_TEST_IS_DIR))  // a new application directory
+			bValid = FALSE;
+	}
+	g_ptr_array_free (paths, TRUE);
+	return bValid;
+}
+
+
+  //////////
+ // SCAN //
+//////////
+
+static desktop_entry *_parse_desktop_file (const char *path, const char *name, const char *prefix, gint64 mtime)
+{
+	desktop_entry *entry = g_new0 (desktop_entry, 1);
+	entry->name = g_strdup (name);
+	entry->mtime = mtime;
+	
+	gchar *filename = g_build_filename (path, name, NULL);
+	GDesktopAppInfo *desktop_app = g_desktop_app_info_new_from_filename (filename);
+	if (!desktop_app)  // not an app (or not installed); keep it anyway, so that it's not parsed again until it's modified
+	{
+		g_free (filename);
+		return entry;
+	}
 	
 	// process ID: make it lowercase and remove .desktop extension
-	char *id_lower = NULL;
-	const char *tmp = strrchr (id, '.');
-	if (tmp && !strcmp(tmp, ".desktop"))
-		id_lower = g_ascii_strdown (id, tmp - id);
-	else id_lower = g_ascii_strdown (id, -1);
+	gchar *id = g_strconcat (prefix, name, NULL);
+	entry->id = g_ascii_strdown (id, strlen (id) - strlen (".desktop"));
+	g_free (id);
 	
-	// check if this ID exists (desktop file names should be unique, so there is no use adding in that case)
-	if (g_hash_table_contains (db->class_table, id_lower))
+	if (g_desktop_app_info_get_is_hidden (desktop_app))  // the app is deleted, it hides the apps with the same ID
 	{
-		g_free (id_lower);
-		return;
+		g_free (filename);
+		g_object_unref (desktop_app);
+		return entry;
 	}
-	
-	// add the app ID to the (main) hash table
-	char *fn_dup = g_strdup (fn);
-	g_hash_table_insert (db->class_table, id_lower, fn_dup);
+	entry->filename = filename;
 	
 	// process commandline and / or wm class (note: this will always return lower case as well)
-	char *alt_id = cairo_dock_guess_class (cmdline, wmclass);
-	if (!alt_id) return;
-	if (!strcmp (alt_id, id_lower))
+	const char *wmclass = g_desktop_app_info_get_startup_wm_class (desktop_app);
+	const char *cmdline = g_app_info_get_commandline (G_APP_INFO (desktop_app));
+	entry->alt_id = cairo_dock_guess_class (cmdline, wmclass);
+	if (entry->alt_id && strcmp (entry->alt_id, entry->id) == 0)
+	{
+		g_free (entry->alt_id);
+		entry->alt_id = NULL;
+	}
+	g_object_unref (desktop_app);
+	return entry;
+}
+
+static desktop_entry *_take_entry (desktop_dir *old_dir, const char *name)
+{
+	if (!old_dir)
+		return NULL;
+	guint i;
+	for (i = 0; i < old_dir->entries->len; i ++)
+	{
+		desktop_entry *entry = g_ptr_array_index (old_dir->entries, i);
+		if (entry && strcmp (entry->name, name) == 0)
+		{
+			old_dir->entries->pdata[i] = NULL;  // the old directory is freed afterwards
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+// scan a directory and its sub-directories, re-using what has not changed since the previous scan; return TRUE if something has changed.
+static gboolean _scan_dir (const char *path, const char *prefix, GHashTable *old_dirs, GPtrArray *new_dirs)
+{
+	gboolean bIsDir = FALSE;
+	gint64 mtime = _get_mtime (path, &bIsDir);
+	desktop_dir *old_dir = g_hash_table_lookup (old_dirs, path);
+	if (mtime < 0 || !bIsDir)
+		return (old_dir != NULL);
+	if (old_dir && strcmp (old_dir->prefix, prefix) != 0)
+		old_dir = NULL;
+	
+	gboolean bChanged = FALSE;
+	desktop_dir *dir = _desktop_dir_new (path, prefix, mtime);
+	g_ptr_array_add (new_dirs, dir);
+	GPtrArray *subdirs = g_ptr_array_new_with_free_func (g_free);
+	
+	if (old_dir && old_dir->mtime == mtime)  // same files as before, only look for the ones that have been modified.
+	{
+		guint i;
+		for (i = 0; i < old_dir->entries->len; i ++)
+		{
+			desktop_entry *entry = g_ptr_array_index (old_dir->entries, i);
+			if (!entry) continue;
+			gchar *filename = g_build_filename (path, entry->name, NULL);
+			gint64 file_mtime = _get_mtime (filename, NULL);
+			g_free (filename);
+			if (file_mtime == entry->mtime)
+			{
+				old_dir->entries->pdata[i] = NULL;
+				g_ptr_array_add (dir->entries, entry);
+			}
+			else if (file_mtime >= 0)
+			{
+				g_ptr_array_add (dir->entries, _parse_desktop_file (path, entry->name, prefix, file_mtime));
+				bChanged = TRUE;
+			}
+			else
+				bChanged = TRUE;
+		}
+		for (i = 0; old_dir->subdirs && old_dir->subdirs[i] != NULL; i ++)
+			g_ptr_array_add (subdirs, g_strdup (old_dir->subdirs[i]));
+	}
+	else  // files have been added or removed, list the directory again.
 	{
-		g_free (alt_id);
-		return;
+		bChanged = TRUE;
+		GDir *d = g_dir_open (path, 0, NULL);
+		if (d)
+		{
+			const gchar *name;
+			while ((name = g_dir_read_name (d)) != NULL)
+			{
+				gchar *filename = g_build_filename (path, name, NULL);
+				gboolean bIsSubDir = FALSE;
+				gint64 file_mtime = _get_mtime (filename, &bIsSubDir);
+				g_free (filename);
+				if (file_mtime < 0)
+					continue;
+				if (bIsSubDir)
+				{
+					g_ptr_array_add (subdirs, g_strdup (name));
+				}
+				else if (g_str_has_suffix (name, ".desktop"))
+				{
+					desktop_entry *entry = _take_entry (old_dir, name);
+					if (entry && entry->mtime != file_mtime)
+					{
+						_desktop_entry_free (entry);
+						entry = NULL;
+					}
+					if (!entry)
+						entry = _parse_desktop_file (path, name, prefix, file_mtime);
+					g_ptr_array_add (dir->entries, entry);
+				}
+			}
+			g_dir_close (d);
+		}
 	}
 	
-	// only add the alternate ID if it does not exist yet
-	if (g_hash_table_contains (db->class_table, alt_id) || g_hash_table_contains(db->alt_class_table, alt_id))
+	// the apps of the sub-directories come after the ones of the directory
+	guint i;
+	for (i = 0; i < subdirs->len; i ++)
 	{
-		g_free (alt_id);
-		return;
+		const char *name = g_ptr_array_index (subdirs, i);
+		gchar *subdir_path = g_build_filename (path, name, NULL);
+		gchar *subdir_prefix = g_strconcat (prefix, name, "-", NULL);
+		bChanged |= _scan_dir (subdir_path, subdir_prefix, old_dirs, new_dirs);
+		g_free (subdir_path);
+		g_free (subdir_prefix);
 	}
-	g_hash_table_insert (db->alt_class_table, alt_id, fn_dup);
+	g_ptr_array_add (subdirs, NULL);
+	dir->subdirs = (char**)g_ptr_array_free (subdirs, FALSE);
+	return bChanged;
+}
+
+// update the index with the changes in the application directories; return TRUE if something has changed.
+static gboolean _update_index (void)
+{
+	GHashTable *old_dirs = g_hash_table_new (g_str_hash, g_str_equal);
+	guint i;
+	if (dirs)
+	{
+		for (i = 0; i < dirs->len; i ++)
+		{
+			desktop_dir *dir = g_ptr_array_index (dirs, i);
+			g_hash_table_insert (old_dirs, dir->path, dir);
+		}
+	}
+	
+	GPtrArray *new_dirs = g_ptr_array_new_with_free_func ((GDestroyNotify)_desktop_dir_free);
+	GPtrArray *paths = _get_app_dirs ();
+	gboolean bChanged = FALSE;
+	for (i = 0; i < paths->len; i ++)
+		bChanged |= _scan_dir (g_ptr_array_index (paths, i), "", old_dirs, new_dirs);
+	g_ptr_array_free (paths, TRUE);
+	
+	if (!dirs || new_dirs->len != g_hash_table_size (old_dirs))  // a directory has been removed, or there was no index
+		bChanged = TRUE;
+	g_hash_table_destroy (old_dirs);
+	if (dirs)
+		g_ptr_array_free (dirs, TRUE);
+	dirs = new_dirs;
+	return bChanged;
+}
+
+static desktop_db *_build_db (GPtrArray *index)
+{
+	desktop_db *db = g_malloc (sizeof(desktop_db));
+	db->class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
+		g_free, g_free);
+	db->alt_class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
+		g_free, NULL);
+	
+	guint i, j;
+	for (i = 0; i < index->len; i ++)
+	{
+		desktop_dir *dir = g_ptr_array_index (index, i);
+		for (j = 0; j < dir->entries->len; j ++)
+		{
+			desktop_entry *entry = g_ptr_array_index (dir->entries, j);
+			if (!entry->id) continue;
+			
+			// check if this ID exists (desktop file names should be unique, so there is no use adding in that case)
+			if (g_hash_table_contains (db->class_table, entry->id))
+				continue;
+			
+			// add the app ID to the (main) hash table; a hidden app is added without file, to hide the next ones
+			char *fn_dup = g_strdup (entry->filename);
+			g_hash_table_insert (db->class_table, g_strdup (entry->id), fn_dup);
+			if (!fn_dup || !entry->alt_id) continue;
+			
+			// only add the alternate ID if it does not exist yet
+			if (g_hash_table_contains (db->class_table, entry->alt_id) || g_hash_table_contains(db->alt_class_table, entry->alt_id))
+				continue;
+			g_hash_table_insert (db->alt_class_table, g_strdup (entry->alt_id), fn_dup);
+		}
+	}
+	return db;
 }
 
 static gpointer _thread_func (gpointer)
@@ -114,17 +499,13 @@ static gpointer _thread_func (gpointer)
 	while (1)
 	{
 		desktop_db *db = NULL;
-		GList *list = g_app_info_get_all ();
+		gboolean bChanged = _update_index ();
 		
-		if (list)
+		if (dirs->len != 0)
 		{
-			db = g_malloc (sizeof(desktop_db));
-			db->class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-				g_free, g_free);
-			db->alt_class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-				g_free, NULL);
-			g_list_foreach (list, _process_app, db);
-			g_list_free_full (list, g_object_unref);
+			db = _build_db (dirs);
+			if (bChanged)
+				_save_index (dirs);
 		}
 		
 		gboolean exit = TRUE;
@@ -171,6 +552,12 @@ static void _on_apps_changed(GAppInfoMonitor*, void*) {
 
 void gldi_desktop_file_db_init ()
 {
+	// serve the lookups from the index right away if it's still valid; the worker thread will bring it up-to-date in any case
+	index_path = g_build_filename (g_get_user_cache_dir (), "cairo-dock", "desktop-file-db", NULL);
+	dirs = _load_index ();
+	if (dirs && _index_is_valid (dirs))
+		db_current = _build_db (dirs);
+	
 	update_pending = TRUE;
 	_start_thread (NULL);
 	monitor = g_app_info_monitor_get();
@@ -199,10 +586,19 @@ void gldi_desktop_file_db_stop (void)
 	_desktop_db_free (db_pending);
 	db_current = NULL;
 	db_pending = NULL;
+	generation ++;
+	if (dirs)
+	{
+		g_ptr_array_free (dirs, TRUE);
+		dirs = NULL;
+	}
+	g_free (index_path);
+	index_path = NULL;
 	error = FALSE;
 }
 
-const char *gldi_desktop_file_db_lookup (const char *class)
+// replace db_current with the database made by the worker thread if there is one, or wait for it if there is no database yet
+static gboolean _update_current_db (gboolean bWait)
 {
 	if (!db_current || g_atomic_pointer_get (&db_pending))
 	{
@@ -210,12 +606,17 @@ const char *gldi_desktop_file_db_lookup (const char *class)
 		g_mutex_lock (&mutex);
 		if (!db_pending)
 		{
+			if (!bWait)
+			{
+				g_mutex_unlock (&mutex);
+				return (db_current != NULL);
+			}
 			// in this case db_current == NULL, we have to wait for the thread (which should be running)
 			if (!thread_running)
 			{
 				g_mutex_unlock (&mutex);
 				cd_error ("no worker thread!\n");
-				return NULL;
+				return FALSE;
 			}
 			
 			while (!(db_pending || error))
@@ -225,7 +626,7 @@ const char *gldi_desktop_file_db_lookup (const char *class)
 			{
 				g_mutex_unlock (&mutex);
 				cd_error ("cannot get app database!\n");
-				return NULL;
+				return FALSE;
 			}
 		}
 		
@@ -233,8 +634,16 @@ const char *gldi_desktop_file_db_lookup (const char *class)
 		_desktop_db_free (db_current);
 		db_current = db_pending;
 		db_pending = NULL;
+		generation ++;
 		g_mutex_unlock (&mutex);
 	}
+	return TRUE;
+}
+
+const char *gldi_desktop_file_db_lookup (const char *class)
+{
+	if (!_update_current_db (TRUE))
+		return NULL;
 	
 	const char *ret = g_hash_table_lookup (db_current->class_table, class);
 	if (!ret) ret = g_hash_table_lookup (db_current->alt_class_table, class);
@@ -242,5 +651,11 @@ const char *gldi_desktop_file_db_lookup (const char *class)
 	return ret;
 }
 
+guint gldi_desktop_file_db_get_generation (void)
+{
+	_update_current_db (FALSE);
+	return generation;
+}
+
 
 
@@ -31,6 +31,11 @@ void gldi_desktop_file_db_stop (void);
 
 const char *gldi_desktop_file_db_lookup (const char *class);
 
+/** Get the generation of the database used for the lookups. It changes each time the database is updated (the new database is taken into account if it is ready), so that the results of the lookups can be cached until then.
+*@return the current generation.
+*/
+guint gldi_desktop_file_db_get_generation (void);
+
 G_END_DECLS
 
 #endif
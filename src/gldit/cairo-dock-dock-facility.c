@@ -36,6 +36,7 @@
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get*
 #include "cairo-dock-data-renderer.h"  // cairo_dock_reload_data_renderer_on_icon
 #include "cairo-dock-opengl.h"  // gldi_gl_container_begin_draw
+#include "cairo-dock-draw.h"  // cairo_dock_invalidate_dock_background_layer
 
 extern CairoDockGLConfig g_openglConfig;
 #include "cairo-dock-dock-facility.h"
@@ -179,6 +180,7 @@ void cairo_dock_update_dock_size (CairoDock *pDock)
 	}
 	
 	// reload its background.
+	cairo_dock_invalidate_dock_background_layer (pDock);
 	cairo_dock_trigger_load_dock_background (pDock);
 	
 	// update the space reserved on the screen.
@@ -1321,6 +1323,7 @@ static void _cairo_dock_load_default_background (CairoDockImageBuffer *pImage, i
 void cairo_dock_load_dock_background (CairoDock *pDock)
 {
 	cairo_dock_unload_image_buffer (&pDock->backgroundBuffer);
+	cairo_dock_invalidate_dock_background_layer (pDock);
 	
 	int iWidth = pDock->iDecorationsWidth;
 	int iHeight = pDock->iDecorationsHeight;
@@ -83,10 +83,73 @@ void cairo_dock_freeze_docks (gboolean bFreeze)
 	s_bFrozenDock = bFreeze;  /// instead, try to connect to the motion-event and intercept it ...
 }
 
+static void _reset_damage (CairoDock *pDock)
+{
+	if (pDock->pDamagedArea != NULL)
+	{
+		cairo_region_destroy (pDock->pDamagedArea);
+		pDock->pDamagedArea = NULL;
+	}
+	pDock->bDamagedEntirely = FALSE;
+}
+
+static gboolean _can_render_damaged_area_only (CairoDock *pDock)
+{
+	return (pDock->pDamagedArea != NULL && ! pDock->bDamagedEntirely
+		&& pDock->pRenderer->render_optimized != NULL && pDock->pRenderer->bCanRenderOptimized  // only the views that have been checked.
+		&& pDock->iMagnitudeIndex == 0 && pDock->fFoldingFactor == 0  // the optimized rendering can only draw a dock at rest.
+		&& pDock->fHideOffset == 0 && pDock->iFadeCounter == 0
+		&& ! pDock->bIsShrinkingDown && ! pDock->bIsGrowingUp);
+}
+
+// If only some icons have been damaged since the last frame, replace the damaged area by the area to render, so that the rendering notification only draws these icons. Otherwise, the dock is marked as entirely damaged.
+static void _compute_area_to_render (CairoDock *pDock, cairo_t *pCairoContext)
+{
+	gboolean bPartial = FALSE;
+	if (_can_render_damaged_area_only (pDock))
+	{
+		cairo_rectangle_list_t *pClipList = cairo_copy_clip_rectangle_list (pCairoContext);
+		if (pClipList->status == CAIRO_STATUS_SUCCESS && pClipList->num_rectangles > 0)
+		{
+			cairo_region_t *pClip = cairo_region_create ();
+			cairo_rectangle_int_t rect;
+			int i;
+			for (i = 0; i < pClipList->num_rectangles; i ++)
+			{
+				rect.x = floor (pClipList->rectangles[i].x);
+				rect.y = floor (pClipList->rectangles[i].y);
+				rect.width = ceil (pClipList->rectangles[i].x + pClipList->rectangles[i].width) - rect.x;
+				rect.height = ceil (pClipList->rectangles[i].y + pClipList->rectangles[i].height) - rect.y;
+				cairo_region_union_rectangle (pClip, &rect);
+			}
+			
+			// the area to draw may have been invalidated by someone else (window uncovered, etc); in this case we can't know what has changed there.
+			cairo_region_t *pOutside = cairo_region_copy (pClip);
+			cairo_region_subtract (pOutside, pDock->pDamagedArea);
+			bPartial = cairo_region_is_empty (pOutside);
+			cairo_region_destroy (pOutside);
+			
+			if (bPartial)
+			{
+				cairo_region_destroy (pDock->pDamagedArea);
+				pDock->pDamagedArea = pClip;
+			}
+			else
+				cairo_region_destroy (pClip);
+		}
+		cairo_rectangle_list_destroy (pClipList);
+	}
+	if (! bPartial)
+		pDock->bDamagedEntirely = TRUE;
+}
+
 static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoContext, CairoDock *pDock)
 {
+	gint64 iStartTime = (G_UNLIKELY (g_bProfilerEnabled) ? g_get_monotonic_time () : 0);
 	if (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL)  // OpenGL rendering
 	{
+		_reset_damage (pDock);  // the clip area is used as a scissor, which already restricts the drawing to the damaged area.
+		
 		GdkRectangle area;
 		double x1, x2, y1, y2;
 		cairo_clip_extents (pCairoContext, &x1, &y1, &x2, &y2);
@@ -127,9 +190,13 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		}
 		else
 		{
+			_compute_area_to_render (pDock, pCairoContext);
 			gldi_object_notify (pDock, NOTIFICATION_RENDER, pDock, pCairoContext);
 		}
 	}
+	_reset_damage (pDock);
+	if (iStartTime != 0)
+		gldi_profiler_record (GLDI_PROFILER_FRAME, pDock->cDockName, g_get_monotonic_time () - iStartTime);
 	return FALSE;
 }
 
@@ -633,6 +700,16 @@ static gboolean _on_leave_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 	return TRUE;
 }
 
+static void _on_unmap (G_GNUC_UNUSED GtkWidget* pWidget, CairoDock *pDock)
+{
+	// an unmapped window doesn't get any frame, so the animation loop must not depend on its frame clock any more.
+	if (pDock->container.iSidGLAnimation != 0 && pDock->container.bAnimationOnFrameClock)
+	{
+		cairo_dock_stop_animation (CAIRO_CONTAINER (pDock));
+		cairo_dock_launch_animation (CAIRO_CONTAINER (pDock));
+	}
+}
+
 static gboolean _on_dock_unmap (GtkWidget* pWidget, G_GNUC_UNUSED GdkEvent* pEvent, CairoDock *pDock)
 {
 	// this event is only necessary on Wayland
@@ -1761,6 +1838,7 @@ static gboolean _cairo_dock_handle_inserting_removing_icons (CairoDock *pDock)
 static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 {
 	CairoDock *pDock = CAIRO_DOCK (pContainer);
+	gint64 iStartTime = (G_UNLIKELY (g_bProfilerEnabled) ? g_get_monotonic_time () : 0);
 	gboolean bContinue = FALSE;
 	gboolean bUpdateSlowAnimation = FALSE;
 	pContainer->iAnimationStep ++;
@@ -1771,6 +1849,16 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 		pContainer->bKeepSlowAnimation = FALSE;
 	}
 	
+	// usually only the animated icons need to be updated; but when the dock itself is changing (size, visibility), all the icons are affected.
+	if (pDock->pAnimatedIcons == NULL)
+	{
+		pDock->pAnimatedIcons = g_hash_table_new (NULL, NULL);
+		pDock->bUpdateAllIcons = TRUE;
+	}
+	gboolean bUpdateAllIcons = (pDock->bUpdateAllIcons
+		|| pDock->bIsShrinkingDown || pDock->bIsGrowingUp || pDock->bIsHiding || pDock->bIsShowing);
+	pDock->bUpdateAllIcons = FALSE;
+	
 	if (pDock->bIsShrinkingDown)
 	{
 		pDock->bIsShrinkingDown = _cairo_dock_shrink_down (pDock);
@@ -1801,11 +1889,15 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	double fDockMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);
 	gboolean bIconIsAnimating;
 	gboolean bNoMoreDemandingAttention = FALSE;
+	gboolean bInsertingRemovingIcons = FALSE;
 	Icon *icon;
 	GList *ic;
-	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+	GList *pAnimatedIcons = (bUpdateAllIcons ? NULL : g_hash_table_get_keys (pDock->pAnimatedIcons));  // a copy, since an update can start or stop the animation of other icons
+	for (ic = (bUpdateAllIcons ? pDock->icons : pAnimatedIcons); ic != NULL; ic = ic->next)
 	{
 		icon = ic->data;
+		if (! bUpdateAllIcons && ! g_hash_table_contains (pDock->pAnimatedIcons, icon))  // it has been detached in the meantime
+			continue;
 		
 		icon->fDeltaYReflection = 0;
 		if (myIconsParam.fAlphaAtRest != 1)
@@ -1825,7 +1917,15 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 		}
 		
 		bContinue |= bIconIsAnimating;
-		if (! bIconIsAnimating)
+		if (bIconIsAnimating && iStartTime != 0)  // tell who keeps the loop alive
+			gldi_profiler_record (GLDI_PROFILER_ANIMATING_ICON, icon->cName, 0);
+		if (icon->fInsertRemoveFactor != 0)
+			bInsertingRemovingIcons = TRUE;
+		if (! bIconIsAnimating && ! bUpdateSlowAnimation && pContainer->bKeepSlowAnimation)
+		{
+			cairo_dock_add_animated_icon (pDock, icon);  // the icon may be animated by the slow updates only, we'll know it on the next slow iteration.
+		}
+		else if (! bIconIsAnimating)
 		{
 			icon->iAnimationState = CAIRO_DOCK_STATE_REST;
 			if (icon->bIsDemandingAttention)
@@ -1833,8 +1933,12 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 				icon->bIsDemandingAttention = FALSE;  // the attention animation has finished by itself after the time it was planned for.
 				bNoMoreDemandingAttention = TRUE;
 			}
+			cairo_dock_remove_animated_icon (pDock, icon);  // at rest, no need to update it any more
 		}
+		else
+			cairo_dock_add_animated_icon (pDock, icon);
 	}
+	g_list_free (pAnimatedIcons);
 	bContinue |= pContainer->bKeepSlowAnimation;
 	
 	if (pDock->iVisibility == CAIRO_DOCK_VISI_KEEP_BELOW && bNoMoreDemandingAttention && ! pDock->bIsBelow && ! pContainer->bInside)
@@ -1843,7 +1947,7 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 		cairo_dock_pop_down (pDock);
 	}
 	
-	if (! _cairo_dock_handle_inserting_removing_icons (pDock))
+	if ((bUpdateAllIcons || bInsertingRemovingIcons) && ! _cairo_dock_handle_inserting_removing_icons (pDock))
 	{
 		cd_debug ("ce dock n'a plus de raison d'etre");
 		return FALSE;
@@ -1855,6 +1959,9 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	}
 	gldi_object_notify (pDock, NOTIFICATION_UPDATE, pDock, &bContinue);
 	
+	if (iStartTime != 0)
+		gldi_profiler_record (GLDI_PROFILER_ANIMATION_LOOP, pDock->cDockName, g_get_monotonic_time () - iStartTime);
+	
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
 	{
 		pContainer->iSidGLAnimation = 0;
@@ -1953,6 +2060,8 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 	CairoDock *pDock = CAIRO_DOCK (pContainer);
 	cd_debug ("%s (%s)", __func__, icon->cName);
 	
+	cairo_dock_remove_animated_icon (pDock, icon);
+	
 	//\___________________ On trouve l'icone et ses 2 voisins.
 	GList *prev_ic = NULL, *ic, *next_ic;
 	Icon *pPrevIcon = NULL, *pNextIcon = NULL;
@@ -2218,6 +2327,10 @@ void gldi_dock_init_internals (CairoDock *pDock)
 		"drag-leave",
 		G_CALLBACK (_on_drag_leave),
 		pDock);
+	g_signal_connect_after (G_OBJECT (pWindow),
+		"unmap",
+		G_CALLBACK (_on_unmap),
+		pDock);
 	/*g_signal_connect (G_OBJECT (pWindow),
 		"drag-drop",
 		G_CALLBACK (_on_drag_drop),
@@ -88,6 +88,8 @@ struct _CairoDockRenderer {
 	gboolean bUseStencil;
 	/// TRUE is the view uses reflects.
 	gboolean bUseReflect;
+	/// TRUE if the optimized rendering draws exactly like the full rendering, so that the dock can redraw only its damaged icons with it. FALSE by default, the views have to opt in.
+	gboolean bCanRenderOptimized;
 	/// name displayed in the GUI (translated).
 	const gchar *cDisplayedName;
 	/// path to a readme file that gives a short description of the view.
@@ -290,6 +292,32 @@ struct _CairoDock {
 	GLuint iRedirectedTexture;
 	GLuint iFboId;
 	
+	//\_______________ animation.
+	/// set of the icons being animated; only these ones are updated by the animation loop.
+	GHashTable *pAnimatedIcons;
+	/// TRUE if all the icons have to be updated on the next iteration of the animation loop.
+	gboolean bUpdateAllIcons;
+	
+	//\_______________ damage.
+	/// area invalidated by the icons since the last frame, or NULL if none.
+	cairo_region_t *pDamagedArea;
+	/// TRUE if something else than the icons has been invalidated since the last frame; the dock is then fully rendered.
+	gboolean bDamagedEntirely;
+	
+	//\_______________ static background.
+	/// layer holding the frame and the decorations of the dock, or NULL if it has to be drawn again.
+	cairo_surface_t *pBackgroundLayer;
+	/// geometry the layer has been drawn with.
+	gdouble fBackgroundLayerOffsetX, fBackgroundLayerWidth;
+	gint iBackgroundLayerWidth, iBackgroundLayerHeight;
+	
+	//\_______________ visibility.
+	/// set of the windows of the current desktop that overlap the dock, or NULL if it has not been computed yet.
+	GHashTable *pOverlappingWindows;
+	/// area of the dock and desktop/viewport the set has been computed for.
+	GdkRectangle overlapArea;
+	gint iOverlapDesktop, iOverlapViewportX, iOverlapViewportY;
+	
 	gpointer reserved[4];
 };
 
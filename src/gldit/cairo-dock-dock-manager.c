@@ -1134,9 +1134,22 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 		if (pDock->iFadeCounter != 0 && g_pKeepingBelowBackend != NULL && g_pKeepingBelowBackend->pre_render)
 			g_pKeepingBelowBackend->pre_render (pDock, (double) pDock->iFadeCounter / myBackendsParam.iHideNbSteps, pCairoContext);
 		
-		/// TODO: see if it's ok to not use the optimized rendering any more...
-		/// if not, we can probably get the clip on the cairo context
-		pDock->pRenderer->render (pCairoContext, pDock);
+		if (pDock->pDamagedArea != NULL && ! pDock->bDamagedEntirely)  // only some icons have changed since the last frame, just draw them.
+		{
+			GdkRectangle area;
+			int i, n = cairo_region_num_rectangles (pDock->pDamagedArea);
+			for (i = 0; i < n; i ++)
+			{
+				cairo_region_get_rectangle (pDock->pDamagedArea, i, &area);
+				cairo_save (pCairoContext);
+				cairo_rectangle (pCairoContext, area.x, area.y, area.width, area.height);
+				cairo_clip (pCairoContext);
+				pDock->pRenderer->render_optimized (pCairoContext, pDock, &area);
+				cairo_restore (pCairoContext);
+			}
+		}
+		else
+			pDock->pRenderer->render (pCairoContext, pDock);
 		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->post_render)
 			g_pHidingBackend->post_render (pDock, pDock->fHideOffset, pCairoContext);
@@ -1565,6 +1578,11 @@ static void load (void)
  /// RELOAD ///
 //////////////
 
+static void _invalidate_background_layer (G_GNUC_UNUSED const gchar *cDockName, CairoDock *pDock, G_GNUC_UNUSED gpointer data)
+{
+	cairo_dock_invalidate_dock_background_layer (pDock);
+	gtk_widget_queue_draw (pDock->container.pWidget);
+}
 static void _reload_bg (CairoDock *pDock, G_GNUC_UNUSED gpointer data)
 {
 	pDock->backgroundBuffer.iWidth ++;  // force the reload
@@ -1710,6 +1728,7 @@ static void unload (void)
 static gboolean on_style_changed (G_GNUC_UNUSED gpointer data)
 {
 	cd_debug ("Docks: style change to %d", myDocksParam.bUseDefaultColors);
+	gldi_docks_foreach ((GHFunc)_invalidate_background_layer, NULL);  // the colors of the frame may have changed
 	if (myDocksParam.bUseDefaultColors)  // reload bg
 	{
 		cd_debug (" reload dock's bg...");
@@ -1919,6 +1938,18 @@ static void reset_object (GldiObject *obj)
 	if (pDock->iSidUpdateDockSize != 0)
 		g_source_remove (pDock->iSidUpdateDockSize);
 	
+	// forget the animated icons, they're going to be destroyed
+	if (pDock->pAnimatedIcons != NULL)
+	{
+		g_hash_table_destroy (pDock->pAnimatedIcons);
+		pDock->pAnimatedIcons = NULL;
+	}
+	if (pDock->pDamagedArea != NULL)
+		cairo_region_destroy (pDock->pDamagedArea);
+	cairo_dock_invalidate_dock_background_layer (pDock);
+	if (pDock->pOverlappingWindows != NULL)
+		g_hash_table_destroy (pDock->pOverlappingWindows);
+	
 	// free icons that are still present
 	GList *icons = pDock->icons;
 	pDock->icons = NULL;  // remove the icons first, to avoid any use of 'icons' in the 'destroy' callbacks.
@@ -144,8 +144,13 @@ static void _hide_if_any_overlap_or_show (CairoDock *pDock, G_GNUC_UNUSED gpoint
  // Callbacks //
 ///////////////
 
+static void _update_overlapping_window (const gchar *cDockName, CairoDock *pDock, GldiWindowActor *actor);
+static void _forget_overlapping_window (const gchar *cDockName, CairoDock *pDock, GldiWindowActor *actor);
+
 static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	gldi_docks_foreach ((GHFunc)_update_overlapping_window, actor);  // all docks, a sub-dock may keep its set and become a root dock later
+	
 	// docks visibility on overlap any
 	/// see how to handle modal dialogs ...
 	gldi_docks_foreach_root ((GFunc)_hide_if_overlap, actor);
@@ -155,6 +160,8 @@ static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor
 
 static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	gldi_docks_foreach ((GHFunc)_forget_overlapping_window, actor);  // all docks, so that no set keeps a destroyed actor
+	
 	// docks visibility on overlap any
 	gboolean bIsHidden = actor->bIsHidden;  // the window is already destroyed, but the actor is still valid (it represents the last state of the window); temporarily make it hidden so that it doesn't overlap the dock (that's a bit tricky, we could also add an "except-this-window" parameter to 'gldi_dock_search_overlapping_window()')
 	actor->bIsHidden = TRUE;
@@ -166,6 +173,8 @@ static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowAct
 
 static gboolean _on_window_size_position_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	gldi_docks_foreach ((GHFunc)_update_overlapping_window, actor);
+	
 	// docks visibility on overlap any
 	if (! gldi_window_is_on_current_desktop (actor))  // not on this desktop/viewport any more
 	{
@@ -187,6 +196,8 @@ static gboolean _on_window_size_position_changed (G_GNUC_UNUSED gpointer data, G
 
 static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor, gboolean bHiddenChanged, G_GNUC_UNUSED gboolean bMaximizedChanged, gboolean bFullScreenChanged)
 {
+	gldi_docks_foreach ((GHFunc)_update_overlapping_window, actor);
+	
 	// docks visibility on overlap active
 	if (actor == gldi_windows_get_active())  // c'est la fenetre courante qui a change d'etat.
 	{
@@ -210,6 +221,8 @@ static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindo
 
 static gboolean _on_window_desktop_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	gldi_docks_foreach ((GHFunc)_update_overlapping_window, actor);
+	
 	// docks visibility on overlap active
 	if (actor == gldi_windows_get_active())  // c'est la fenetre courante qui a change de bureau.
 	{
@@ -265,27 +278,29 @@ void gldi_dock_hide_if_any_window_overlap_or_show (CairoDock *pDock)
 	_hide_if_any_overlap_or_show (pDock, NULL);
 }
 
-static inline gboolean _window_overlaps_dock (GtkAllocation *pWindowGeometry, gboolean bIsHidden, CairoDock *pDock)
+static void _get_dock_area (CairoDock *pDock, GdkRectangle *pArea)
+{
+	if (pDock->container.bIsHorizontal)
+	{
+		pArea->width = pDock->iMinDockWidth;
+		pArea->height = pDock->iMinDockHeight;
+		pArea->x = pDock->container.iWindowPositionX + (pDock->container.iWidth - pArea->width)/2;
+		pArea->y = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+	}
+	else
+	{
+		pArea->width = pDock->iMinDockHeight;
+		pArea->height = pDock->iMinDockWidth;
+		pArea->x = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+		pArea->y = pDock->container.iWindowPositionX + (pDock->container.iWidth - pArea->height)/2;
+	}
+}
+
+static inline gboolean _window_overlaps_area (GtkAllocation *pWindowGeometry, gboolean bIsHidden, GdkRectangle *pArea)
 {
 	if (!bIsHidden && pWindowGeometry->width != 0 && pWindowGeometry->height != 0)
 	{
-		int iDockX, iDockY, iDockWidth, iDockHeight;
-		if (pDock->container.bIsHorizontal)
-		{
-			iDockWidth = pDock->iMinDockWidth;
-			iDockHeight = pDock->iMinDockHeight;
-			iDockX = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockWidth)/2;
-			iDockY = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-		}
-		else
-		{
-			iDockWidth = pDock->iMinDockHeight;
-			iDockHeight = pDock->iMinDockWidth;
-			iDockX = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-			iDockY = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockHeight)/2;
-		}
-		
-		if (pWindowGeometry->x < iDockX + iDockWidth && pWindowGeometry->x + pWindowGeometry->width > iDockX && pWindowGeometry->y < iDockY + iDockHeight && pWindowGeometry->y + pWindowGeometry->height > iDockY)
+		if (pWindowGeometry->x < pArea->x + pArea->width && pWindowGeometry->x + pWindowGeometry->width > pArea->x && pWindowGeometry->y < pArea->y + pArea->height && pWindowGeometry->y + pWindowGeometry->height > pArea->y)
 		{
 			return TRUE;
 		}
@@ -298,7 +313,9 @@ static inline gboolean _window_overlaps_dock (GtkAllocation *pWindowGeometry, gb
 }
 gboolean gldi_dock_overlaps_window (CairoDock *pDock, GldiWindowActor *actor)
 {
-	return _window_overlaps_dock (&actor->windowGeometry, actor->bIsHidden || !actor->bDisplayed, pDock);
+	GdkRectangle area;
+	_get_dock_area (pDock, &area);
+	return _window_overlaps_area (&actor->windowGeometry, actor->bIsHidden || !actor->bDisplayed, &area);
 }
 
 static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer data)
@@ -313,9 +330,71 @@ static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer da
 	}
 	return FALSE;
 }
+
+/* Each dock keeps the set of windows that overlap it on the current desktop; it is updated when a window changes, so that we don't have to go through all the windows each time.
+ * It is computed for a given area of the dock and a given desktop/viewport, and is re-computed entirely when one of them changes.
+ */
+static gboolean _overlapping_windows_are_valid (CairoDock *pDock)
+{
+	if (pDock->pOverlappingWindows == NULL)
+		return FALSE;
+	GdkRectangle area;
+	_get_dock_area (pDock, &area);
+	return (gdk_rectangle_equal (&area, &pDock->overlapArea)
+		&& pDock->iOverlapDesktop == g_desktopGeometry.iCurrentDesktop
+		&& pDock->iOverlapViewportX == g_desktopGeometry.iCurrentViewportX
+		&& pDock->iOverlapViewportY == g_desktopGeometry.iCurrentViewportY);
+}
+
+static gboolean _add_if_overlapping_dock (GldiWindowActor *actor, CairoDock *pDock)
+{
+	if (_window_is_overlapping_dock (actor, pDock))
+		g_hash_table_add (pDock->pOverlappingWindows, actor);
+	return FALSE;  // continue
+}
+static void _compute_overlapping_windows (CairoDock *pDock)
+{
+	if (pDock->pOverlappingWindows == NULL)
+		pDock->pOverlappingWindows = g_hash_table_new (g_direct_hash, g_direct_equal);
+	else
+		g_hash_table_remove_all (pDock->pOverlappingWindows);
+	_get_dock_area (pDock, &pDock->overlapArea);
+	pDock->iOverlapDesktop = g_desktopGeometry.iCurrentDesktop;
+	pDock->iOverlapViewportX = g_desktopGeometry.iCurrentViewportX;
+	pDock->iOverlapViewportY = g_desktopGeometry.iCurrentViewportY;
+	
+	gldi_windows_find ((gboolean (*) (GldiWindowActor*, gpointer))_add_if_overlapping_dock, pDock);
+}
+
+static void _update_overlapping_window (G_GNUC_UNUSED const gchar *cDockName, CairoDock *pDock, GldiWindowActor *actor)
+{
+	if (! _overlapping_windows_are_valid (pDock))  // not used yet or out of date, it will be computed when needed.
+		return;
+	if (_window_is_overlapping_dock (actor, pDock))
+		g_hash_table_add (pDock->pOverlappingWindows, actor);
+	else
+		g_hash_table_remove (pDock->pOverlappingWindows, actor);
+}
+
+static void _forget_overlapping_window (G_GNUC_UNUSED const gchar *cDockName, CairoDock *pDock, GldiWindowActor *actor)
+{
+	if (pDock->pOverlappingWindows != NULL)
+		g_hash_table_remove (pDock->pOverlappingWindows, actor);
+}
+
 GldiWindowActor *gldi_dock_search_overlapping_window (CairoDock *pDock)
 {
-	return gldi_windows_find (_window_is_overlapping_dock, pDock);
+	if (pDock->iRefCount > 0)  // only root docks are kept up-to-date.
+		return gldi_windows_find (_window_is_overlapping_dock, pDock);
+	if (! _overlapping_windows_are_valid (pDock))
+		_compute_overlapping_windows (pDock);
+	
+	GHashTableIter iter;
+	gpointer actor = NULL;
+	g_hash_table_iter_init (&iter, pDock->pOverlappingWindows);
+	if (g_hash_table_iter_next (&iter, &actor, NULL))
+		return actor;
+	return NULL;
 }
 
 
@@ -32,6 +32,11 @@
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl-path.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_image_buffer_texture_modified
+#include "cairo-dock-icon-manager.h"  // myIconObjectMgr
+#include "cairo-dock-indicator-manager.h"  // cairo_dock_render_indicator_notification
+#include "cairo-dock-draw.h"  // cairo_dock_render_icon_notification
+#include "cairo-dock-icon-atlas.h"
 
 #include "cairo-dock-draw-opengl.h"
 
@@ -303,8 +308,35 @@ void cairo_dock_translate_on_icon_opengl (Icon *icon, GldiContainer *pContainer,
 		glTranslatef ( (fY + icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2)),  (fX), - icon->fHeight * fMaxScale);
 }
 
+static inline void _apply_appli_alpha (Icon *icon)
+{
+	if (CAIRO_DOCK_IS_APPLI (icon) && myTaskbarParam.fVisibleAppliAlpha != 0 && ! GLDI_OBJECT_IS_APPLET_ICON (icon) && !(myTaskbarParam.iMinimizedWindowRenderType == 1 && icon->pAppli->bIsHidden))
+	{
+		double fAlpha = (icon->pAppli->bIsHidden ? MIN (1 - myTaskbarParam.fVisibleAppliAlpha, 1) : MIN (myTaskbarParam.fVisibleAppliAlpha + 1, 1));
+		if (fAlpha != 1)
+			icon->fAlpha = fAlpha;  // astuce bidon pour pas multiplier 2 fois.
+	}
+}
+
+static inline void _get_icon_center (Icon *icon, GldiContainer *pContainer, double fX, double fY, double *pCenterX, double *pCenterY, double *pCenterZ)
+{
+	if (pContainer->bIsHorizontal)
+	{
+		*pCenterX = fX;
+		*pCenterY = fY - icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2);
+	}
+	else
+	{
+		*pCenterX = fY + icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2);
+		*pCenterY = fX;
+	}
+	*pCenterZ = - icon->fHeight * icon->fScale;
+}
+
 void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDockMagnitude, gboolean bUseText)
 {
+	gboolean bDrawnInBatch = icon->bDrawnInBatch;  // the icon and its reflect are already drawn, as well as what goes below it.
+	icon->bDrawnInBatch = FALSE;
 	if (icon->image.iTexture == 0)
 		return ;
 	double fRatio = pDock->container.fRatio;
@@ -317,22 +349,16 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 			pDock->container.bIsHorizontal ? 48:1);
 		cd_debug ("g_pGradationTexture(%d) <- %d", pDock->container.bIsHorizontal, g_pGradationTexture[pDock->container.bIsHorizontal]);
 	}
-	if (CAIRO_DOCK_IS_APPLI (icon) && myTaskbarParam.fVisibleAppliAlpha != 0 && ! GLDI_OBJECT_IS_APPLET_ICON (icon) && !(myTaskbarParam.iMinimizedWindowRenderType == 1 && icon->pAppli->bIsHidden))
-	{
-		double fAlpha = (icon->pAppli->bIsHidden ? MIN (1 - myTaskbarParam.fVisibleAppliAlpha, 1) : MIN (myTaskbarParam.fVisibleAppliAlpha + 1, 1));
-		if (fAlpha != 1)
-			icon->fAlpha = fAlpha;  // astuce bidon pour pas multiplier 2 fois.
-	}
+	_apply_appli_alpha (icon);
 	
 	//\_____________________ On se place au centre de l'icone.
 	double fX=0, fY=0;
 	_compute_icon_coordinate (icon, CAIRO_CONTAINER (pDock), fDockMagnitude * pDock->fMagnitudeMax, &fX, &fY);
 	
 	glPushMatrix ();
-	if (pDock->container.bIsHorizontal)
-		glTranslatef (fX, fY - icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2), - icon->fHeight * icon->fScale);
-	else
-		glTranslatef (fY + icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2), fX, - icon->fHeight * icon->fScale);
+	double fCenterX, fCenterY, fCenterZ;
+	_get_icon_center (icon, CAIRO_CONTAINER (pDock), fX, fY, &fCenterX, &fCenterY, &fCenterZ);
+	glTranslatef (fCenterX, fCenterY, fCenterZ);
 	
 	//\_____________________ On positionne l'icone.
 	glPushMatrix ();
@@ -377,8 +403,9 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 		glRotatef (icon->iRotationY, 0., 1., 0.);
 	
 	//\_____________________ On dessine l'icone.
-	gboolean bIconHasBeenDrawn = FALSE;
-	gldi_object_notify (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON, icon, pDock, NULL);
+	gboolean bIconHasBeenDrawn = bDrawnInBatch;
+	if (! bDrawnInBatch)
+		gldi_object_notify (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON, icon, pDock, NULL);
 	gldi_object_notify (&myIconObjectMgr, NOTIFICATION_RENDER_ICON, icon, pDock, &bIconHasBeenDrawn, NULL);
 	
 	glPopMatrix ();  // retour juste apres la translation au milieu de l'icone.
@@ -484,6 +511,292 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 }
 
 
+  ///////////
+ // BATCH //
+///////////
+
+// a vertex of the batch
+typedef struct {
+	GLfloat x, y, z;
+	GLfloat u, v;
+	GLfloat r, g, b, a;
+	} CairoDockBatchVertex;
+
+static GArray *s_pOpaqueIconsVertices = NULL;  // icons drawn with a full alpha
+static GArray *s_pTranslucentIconsVertices = NULL;  // icons drawn with an alpha, they need another blending
+static GArray *s_pReflectsVertices = NULL;
+
+typedef struct {
+	double fMin, fMax;
+	} CDIconExtent;
+static GArray *s_pIconsExtents = NULL;  // extents of the drawn icons along the dock
+
+static gboolean _notification_has_only (GldiObject *pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction1, GldiNotificationFunc pFunction2)
+{
+	if (iNotifType >= pObject->iNbNotifications)
+		return TRUE;
+	GldiNotificationList *pList = &pObject->pNotifications[iNotifType];
+	guint i;
+	for (i = 0; i < pList->iNbRecords; i ++)
+	{
+		GldiNotificationFunc pFunction = pList->pRecords[i].pFunction;
+		if (pFunction != NULL && pFunction != pFunction1 && pFunction != pFunction2)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+// the icons can be drawn in a batch only if the core is alone to render them (the image and its reflect, and the indicators); anything registered by a plug-in can draw the icon its own way.
+static gboolean _only_core_renders_icons (void)
+{
+	GldiObject *obj;
+	for (obj = GLDI_OBJECT (&myIconObjectMgr); obj != NULL; obj = GLDI_OBJECT (obj->mgr))
+	{
+		if (! _notification_has_only (obj, NOTIFICATION_PRE_RENDER_ICON,
+			(GldiNotificationFunc) cairo_dock_pre_render_indicator_notification,
+			NULL)
+		|| ! _notification_has_only (obj, NOTIFICATION_RENDER_ICON,
+			(GldiNotificationFunc) cairo_dock_render_icon_notification,
+			(GldiNotificationFunc) cairo_dock_render_indicator_notification))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+// same conditions as cairo_dock_render_one_icon_opengl() to draw the icon without any transformation; an external texture (a window's) can't go in the atlas.
+static inline gboolean _icon_can_be_batched (Icon *icon)
+{
+	return (icon->image.iTexture != 0
+		&& ! icon->image.bExternalTexture
+		&& ! GLDI_OBJECT_IS_SEPARATOR_ICON (icon)
+		&& icon->fOrientation == 0
+		&& icon->iRotationX == 0
+		&& icon->iRotationY == 0);
+}
+
+static int _compare_extents (const CDIconExtent *e1, const CDIconExtent *e2)
+{
+	return (e1->fMin < e2->fMin ? -1 : e1->fMin > e2->fMin ? 1 : 0);
+}
+
+// the batch draws all the images first, and then what goes on top of each icon; so it must not be used when an icon can cover its neighbour (ex.: a gliding icon being dragged, or icons packed tighter than their size), otherwise an icon would be drawn over the label or the indicator of the previous one, or below the image of the next one.
+static gboolean _icons_overlap (CairoDock *pDock, GList *pFirstDrawnElement, double fDockMagnitude)
+{
+	if (s_pIconsExtents == NULL)
+		s_pIconsExtents = g_array_new (FALSE, FALSE, sizeof (CDIconExtent));
+	g_array_set_size (s_pIconsExtents, 0);
+	
+	CDIconExtent e;
+	double fX, fY, fSizeX, fSizeY, fSize;
+	Icon *icon;
+	GList *ic = pFirstDrawnElement;
+	do
+	{
+		icon = ic->data;
+		if (icon->image.iTexture != 0)  // same condition as cairo_dock_render_one_icon_opengl() to draw the icon.
+		{
+			_compute_icon_coordinate (icon, CAIRO_CONTAINER (pDock), fDockMagnitude * pDock->fMagnitudeMax, &fX, &fY);
+			cairo_dock_get_current_icon_size (icon, CAIRO_CONTAINER (pDock), &fSizeX, &fSizeY);
+			fSize = (pDock->container.bIsHorizontal ? fSizeX : fSizeY);  // fX is the center of the icon along the dock, in both orientations.
+			e.fMin = fX - fSize / 2;
+			e.fMax = fX + fSize / 2;
+			g_array_append_val (s_pIconsExtents, e);
+		}
+		ic = cairo_dock_get_next_element (ic, pDock->icons);
+	} while (ic != pFirstDrawnElement);
+	
+	g_array_sort (s_pIconsExtents, (GCompareFunc) _compare_extents);
+	CDIconExtent *pExtents = (CDIconExtent*) s_pIconsExtents->data;
+	guint i;
+	for (i = 1; i < s_pIconsExtents->len; i ++)
+	{
+		if (pExtents[i].fMin < pExtents[i-1].fMax - 1)  // 1 pixel of tolerance for the rounding.
+			return TRUE;
+	}
+	return FALSE;
+}
+
+// add a quad (-.5,.5) (.5,.5) (.5,-.5) (-.5,-.5), scaled by (sx,sy) and centered on (x,y,z); the texture coordinates (s,t) of the image are mapped to its location in the atlas.
+static void _add_quad (GArray *pVertices, double x, double y, double z, double sx, double sy, const GLfloat *pAtlasCoords, const GLfloat *pTexCoords, const GLfloat *pAlphas)
+{
+	CairoDockBatchVertex v[4];
+	const double vx[4] = {-.5, .5, .5, -.5};
+	const double vy[4] = {.5, .5, -.5, -.5};
+	GLfloat du = pAtlasCoords[2] - pAtlasCoords[0];
+	GLfloat dv = pAtlasCoords[3] - pAtlasCoords[1];
+	int i;
+	for (i = 0; i < 4; i ++)
+	{
+		v[i].x = x + vx[i] * sx;
+		v[i].y = y + vy[i] * sy;
+		v[i].z = z;
+		v[i].u = pAtlasCoords[0] + pTexCoords[2*i] * du;
+		v[i].v = pAtlasCoords[1] + pTexCoords[2*i+1] * dv;
+		v[i].r = v[i].g = v[i].b = 1.;
+		v[i].a = pAlphas[i];
+	}
+	g_array_append_vals (pVertices, v, 4);
+}
+
+// same geometry as cairo_dock_draw_icon_reflect_opengl()
+static void _add_icon_reflect (Icon *icon, CairoDock *pDock, double x, double y, double z, const GLfloat *pAtlasCoords)
+{
+	double fScale = icon->fScale;
+	double fReflectSize = icon->fHeight * myIconsParam.fReflectHeightRatio * fScale;
+	double fReflectRatio = myIconsParam.fReflectHeightRatio;
+	double fOffsetY = icon->fHeight * fScale/2 + fReflectSize / 2 + icon->fDeltaYReflection;
+	double fReflectWidth = icon->fWidth * icon->fWidthFactor * fScale;
+	double sx, sy;
+	GLfloat x0, y0, x1, y1;
+	if (pDock->container.bIsHorizontal)
+	{
+		sx = fReflectWidth;
+		x0 = 0.;
+		x1 = 1.;
+		if (pDock->container.bDirectionUp)
+		{
+			y -= fOffsetY;
+			sy = - fReflectSize;
+			y0 = 1. - fReflectRatio;
+			y1 = 1.;
+		}
+		else
+		{
+			y += fOffsetY;
+			sy = fReflectSize;
+			y0 = fReflectRatio;
+			y1 = 0.;
+		}
+	}
+	else
+	{
+		sy = fReflectWidth;
+		y0 = 0.;
+		y1 = 1.;
+		if (pDock->container.bDirectionUp)
+		{
+			x += fOffsetY;
+			sx = - fReflectSize;
+			x0 = 1. - fReflectRatio;
+			x1 = 1.;
+		}
+		else
+		{
+			x -= fOffsetY;
+			sx = fReflectSize;
+			x0 = fReflectRatio;
+			x1 = 0.;
+		}
+	}
+	GLfloat pTexCoords[8] = {x0, y0, x1, y0, x1, y1, x0, y1};
+	GLfloat fReflectAlpha = myIconsParam.fAlbedo * icon->fAlpha;
+	GLfloat fShadedAlpha = fReflectAlpha * icon->fReflectShading;
+	GLfloat pAlphas[4] = {fShadedAlpha,
+		pDock->container.bIsHorizontal ? fShadedAlpha : fReflectAlpha,
+		fReflectAlpha,
+		pDock->container.bIsHorizontal ? fReflectAlpha : fShadedAlpha};
+	_add_quad (s_pReflectsVertices, x, y, z, sx, sy, pAtlasCoords, pTexCoords, pAlphas);
+}
+
+static void _draw_vertices (GArray *pVertices)
+{
+	if (pVertices->len == 0)
+		return;
+	CairoDockBatchVertex *v = (CairoDockBatchVertex*) pVertices->data;
+	glVertexPointer (3, GL_FLOAT, sizeof (CairoDockBatchVertex), &v->x);
+	glTexCoordPointer (2, GL_FLOAT, sizeof (CairoDockBatchVertex), &v->u);
+	glColorPointer (4, GL_FLOAT, sizeof (CairoDockBatchVertex), &v->r);
+	glDrawArrays (GL_QUADS, 0, pVertices->len);
+}
+
+gboolean cairo_dock_render_icons_batch_opengl (CairoDock *pDock, GList *pFirstDrawnElement, double fDockMagnitude)
+{
+	if (pFirstDrawnElement == NULL || ! _only_core_renders_icons () || _icons_overlap (pDock, pFirstDrawnElement, fDockMagnitude) || ! cairo_dock_icon_atlas_begin ())
+		return FALSE;
+	
+	if (s_pOpaqueIconsVertices == NULL)
+	{
+		s_pOpaqueIconsVertices = g_array_new (FALSE, FALSE, sizeof (CairoDockBatchVertex));
+		s_pTranslucentIconsVertices = g_array_new (FALSE, FALSE, sizeof (CairoDockBatchVertex));
+		s_pReflectsVertices = g_array_new (FALSE, FALSE, sizeof (CairoDockBatchVertex));
+	}
+	g_array_set_size (s_pOpaqueIconsVertices, 0);
+	g_array_set_size (s_pTranslucentIconsVertices, 0);
+	g_array_set_size (s_pReflectsVertices, 0);
+	
+	//\_____________________ build the quads of the icons and their reflects.
+	const GLfloat pTexCoords[8] = {0., 0., 1., 0., 1., 1., 0., 1.};
+	GLfloat pAtlasCoords[4];
+	double fX, fY, fCenterX, fCenterY, fCenterZ, fSizeX, fSizeY;
+	Icon *icon;
+	GList *ic = pFirstDrawnElement;
+	do
+	{
+		icon = ic->data;
+		if (_icon_can_be_batched (icon) && cairo_dock_icon_atlas_get_image_coords (&icon->image, pAtlasCoords))
+		{
+			_apply_appli_alpha (icon);
+			_compute_icon_coordinate (icon, CAIRO_CONTAINER (pDock), fDockMagnitude * pDock->fMagnitudeMax, &fX, &fY);
+			_get_icon_center (icon, CAIRO_CONTAINER (pDock), fX, fY, &fCenterX, &fCenterY, &fCenterZ);
+			
+			// what goes below the icon has to be drawn before it.
+			glPushMatrix ();
+			glTranslatef (fCenterX, fCenterY, fCenterZ);
+			gldi_object_notify (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON, icon, pDock, NULL);
+			glPopMatrix ();
+			
+			cairo_dock_get_current_icon_size (icon, CAIRO_CONTAINER (pDock), &fSizeX, &fSizeY);
+			GLfloat pAlphas[4] = {icon->fAlpha, icon->fAlpha, icon->fAlpha, icon->fAlpha};
+			_add_quad (icon->fAlpha == 1 ? s_pOpaqueIconsVertices : s_pTranslucentIconsVertices,
+				fCenterX, fCenterY, fCenterZ,
+				fSizeX, fSizeY,
+				pAtlasCoords, pTexCoords, pAlphas);
+			if (pDock->container.bUseReflect)
+				_add_icon_reflect (icon, pDock, fCenterX, fCenterY, fCenterZ, pAtlasCoords);
+			icon->bDrawnInBatch = TRUE;
+		}
+		ic = cairo_dock_get_next_element (ic, pDock->icons);
+	} while (ic != pFirstDrawnElement);
+	
+	if (s_pOpaqueIconsVertices->len == 0 && s_pTranslucentIconsVertices->len == 0)
+		return FALSE;
+	
+	//\_____________________ draw them, with 1 draw call per kind of blending.
+	_cairo_dock_enable_texture ();
+	glBindTexture (GL_TEXTURE_2D, cairo_dock_icon_atlas_get_texture ());
+	glEnableClientState (GL_VERTEX_ARRAY);
+	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState (GL_COLOR_ARRAY);
+	
+	_cairo_dock_set_blend_pbuffer ();
+	_draw_vertices (s_pOpaqueIconsVertices);
+	
+	_cairo_dock_set_blend_alpha ();
+	_draw_vertices (s_pTranslucentIconsVertices);
+	
+	if (s_pReflectsVertices->len != 0)
+	{
+		gboolean bUseStencil = (pDock->pRenderer->bUseStencil && g_openglConfig.bStencilBufferAvailable);
+		if (bUseStencil)
+		{
+			glEnable (GL_STENCIL_TEST);
+			glStencilFunc (GL_EQUAL, 1, 1);
+			glStencilOp (GL_KEEP, GL_KEEP, GL_KEEP);
+		}
+		_draw_vertices (s_pReflectsVertices);
+		if (bUseStencil)
+			glDisable (GL_STENCIL_TEST);
+	}
+	
+	glDisableClientState (GL_COLOR_ARRAY);
+	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState (GL_VERTEX_ARRAY);
+	glColor4f (1., 1., 1., 1.);  // the color array leaves the current color undefined
+	_cairo_dock_disable_texture ();
+	return TRUE;
+}
+
+
 void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock)
 {
 	//g_print ("%s (%d, %x)\n", __func__, pDock->bIsMainDock, g_pVisibleZoneSurface);
@@ -794,6 +1107,7 @@ void cairo_dock_update_icon_texture (Icon *pIcon)
 				GL_UNSIGNED_BYTE,
 				cairo_image_surface_get_data (pIcon->image.pSurface));
 		glDisable (GL_TEXTURE_2D);
+		cairo_dock_image_buffer_texture_modified (&pIcon->image);
 	}
 }
 
@@ -891,6 +1205,7 @@ void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer,
 		{
 			iOriginalTexture = pIcon->image.iTexture;
 			pIcon->image.iTexture = cairo_dock_create_texture_from_surface (pIcon->image.pSurface);
+			cairo_dock_image_buffer_texture_modified (&pIcon->image);
 			/// Using FBOs copies the texture data (pixels) within VRAM only:
 			/// - setup & bind FBO
 			/// - setup destination texture (using glTexImage() w/ pixels = 0)
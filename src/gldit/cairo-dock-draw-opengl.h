@@ -53,6 +53,16 @@ void cairo_dock_translate_on_icon_opengl (Icon *icon, GldiContainer *pContainer,
 */
 void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDockMagnitude, gboolean bUseText);
 
+/** Draw at once the icons of a linear dock that don't need any special rendering, with their reflects. Their images are taken from the icons atlas, so that they are drawn with a few draw calls, instead of 2 per icon. This is only possible when nothing else than the core renders the icons (otherwise the icons are left untouched and have to be drawn one by one).
+* The icons drawn this way are marked, so that \ref cairo_dock_render_one_icon_opengl only draws what goes on top of them (indicators, overlays, label); so it still has to be called for each icon, after this function.
+* Note that the draw order is not the same as when drawing the icons one by one: all the images (and their reflects) are drawn first, and then what goes on top of each icon. Therefore nothing is drawn if some icons overlap along the dock (the icons are then left to be drawn one by one); an indicator or a label larger than its icon may still be drawn over the image of its neighbour.
+*@param pDock the dock.
+*@param pFirstDrawnElement the first icon to draw, as given by \ref cairo_dock_get_first_drawn_element_linear.
+*@param fDockMagnitude current magnitude of the dock.
+*@return TRUE if some icons have been drawn.
+*/
+gboolean cairo_dock_render_icons_batch_opengl (CairoDock *pDock, GList *pFirstDrawnElement, double fDockMagnitude);
+
 void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock);
 
   //////////////////
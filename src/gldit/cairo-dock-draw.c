@@ -321,6 +321,68 @@ void cairo_dock_render_decorations_in_frame (cairo_t *pCairoContext, CairoDock *
 }
 
 
+void cairo_dock_invalidate_dock_background_layer (CairoDock *pDock)
+{
+	if (pDock->pBackgroundLayer != NULL)
+	{
+		cairo_surface_destroy (pDock->pBackgroundLayer);
+		pDock->pBackgroundLayer = NULL;
+	}
+}
+
+cairo_t *cairo_dock_begin_draw_dock_background_layer (cairo_t *pCairoContext, CairoDock *pDock, double fFrameOffsetX, double fFrameWidth)
+{
+	int iWidth = (pDock->container.bIsHorizontal ? pDock->container.iWidth : pDock->container.iHeight);
+	int iHeight = (pDock->container.bIsHorizontal ? pDock->container.iHeight : pDock->container.iWidth);
+	
+	if (pDock->pBackgroundLayer != NULL
+	&& (pDock->fBackgroundLayerOffsetX != fFrameOffsetX || pDock->fBackgroundLayerWidth != fFrameWidth
+		|| pDock->iBackgroundLayerWidth != iWidth || pDock->iBackgroundLayerHeight != iHeight))  // the geometry has changed
+		cairo_dock_invalidate_dock_background_layer (pDock);
+	
+	if (pDock->pBackgroundLayer != NULL)  // the layer is up-to-date, no need to draw anything.
+		return NULL;
+	
+	if (pDock->fBackgroundLayerOffsetX != fFrameOffsetX || pDock->fBackgroundLayerWidth != fFrameWidth
+	|| pDock->iBackgroundLayerWidth != iWidth || pDock->iBackgroundLayerHeight != iHeight)  // the geometry is still changing (the dock is zooming, etc): draw directly on the dock, and wait for it to be stable before caching it.
+	{
+		pDock->fBackgroundLayerOffsetX = fFrameOffsetX;
+		pDock->fBackgroundLayerWidth = fFrameWidth;
+		pDock->iBackgroundLayerWidth = iWidth;
+		pDock->iBackgroundLayerHeight = iHeight;
+		return pCairoContext;
+	}
+	
+	pDock->pBackgroundLayer = cairo_surface_create_similar (cairo_get_target (pCairoContext),
+		CAIRO_CONTENT_COLOR_ALPHA,
+		iWidth,
+		iHeight);
+	cairo_t *pLayerContext = cairo_create (pDock->pBackgroundLayer);
+	if (cairo_status (pLayerContext) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_destroy (pLayerContext);
+		cairo_dock_invalidate_dock_background_layer (pDock);
+		return pCairoContext;
+	}
+	return pLayerContext;
+}
+
+void cairo_dock_end_draw_dock_background_layer (cairo_t *pCairoContext, CairoDock *pDock, cairo_t *pLayerContext)
+{
+	if (pLayerContext == pCairoContext)  // it has been drawn directly.
+		return;
+	if (pLayerContext != NULL)
+		cairo_destroy (pLayerContext);
+	if (pDock->pBackgroundLayer != NULL)
+	{
+		cairo_save (pCairoContext);
+		cairo_set_source_surface (pCairoContext, pDock->pBackgroundLayer, 0., 0.);
+		cairo_paint (pCairoContext);
+		cairo_restore (pCairoContext);
+	}
+}
+
+
 void cairo_dock_set_icon_scale_on_context (cairo_t *pCairoContext, Icon *icon, gboolean bIsHorizontal, G_GNUC_UNUSED double fRatio, gboolean bDirectionUp)
 {
 	if (bIsHorizontal)
@@ -92,6 +92,27 @@ double cairo_dock_draw_frame (cairo_t *pCairoContext, double fRadius, double fLi
 */
 void cairo_dock_render_decorations_in_frame (cairo_t *pCairoContext, CairoDock *pDock, double fOffsetY, double fOffsetX, double fWidth);
 
+/** Begin to draw the static background of a dock (its frame and the decorations inside). This background is kept in a layer and only drawn again when its geometry changes or when it is invalidated, the rest of the time the layer is just painted on the dock.
+*@param pCairoContext the context of the dock.
+*@param pDock the dock.
+*@param fFrameOffsetX position of the frame, in the direction of the width of the dock.
+*@param fFrameWidth width of the frame.
+*@return the context on which to draw the background, or NULL if the layer is up-to-date and nothing has to be drawn. In any case, call \ref cairo_dock_end_draw_dock_background_layer afterwards.
+*/
+cairo_t *cairo_dock_begin_draw_dock_background_layer (cairo_t *pCairoContext, CairoDock *pDock, double fFrameOffsetX, double fFrameWidth);
+
+/** Finish drawing the static background of a dock, and paint it on the dock.
+*@param pCairoContext the context of the dock.
+*@param pDock the dock.
+*@param pLayerContext the context returned by \ref cairo_dock_begin_draw_dock_background_layer.
+*/
+void cairo_dock_end_draw_dock_background_layer (cairo_t *pCairoContext, CairoDock *pDock, cairo_t *pLayerContext);
+
+/** Invalidate the static background of a dock, so that it is drawn again on the next frame. It is done when the size or the background of the dock change, or when the style changes.
+*@param pDock the dock.
+*/
+void cairo_dock_invalidate_dock_background_layer (CairoDock *pDock);
+
 
 void cairo_dock_set_icon_scale_on_context (cairo_t *pCairoContext, Icon *icon, gboolean bIsHorizontal, double fRatio, gboolean bDirectionUp);
 
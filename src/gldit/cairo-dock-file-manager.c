@@ -23,8 +23,13 @@
 #include <fcntl.h>  // open
 #include <sys/sendfile.h>  // sendfile
 #include <errno.h>  // errno
+#include <unistd.h>  // close
+#include <glib-unix.h>  // g_unix_fd_add
 
 #include "gldi-config.h"
+#ifdef HAVE_PIDFD_OPEN
+#include <sys/pidfd.h>  // pidfd_open
+#endif
 #include "cairo-dock-dock-factory.h"
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-desklet-factory.h"  // cairo_dock_fm_create_icon_from_URI
@@ -37,6 +42,7 @@
 #include "cairo-dock-container.h"
 #include "cairo-dock-utils.h"  // cairo_dock_launch_command_sync, cairo_dock_property_is_present_on_root
 #include "cairo-dock-icon-manager.h"  // cairo_dock_free_icon
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_sync_keyfile
 #define _MANAGER_DEF_
 #include "cairo-dock-file-manager.h"
 
@@ -489,6 +495,8 @@ int cairo_dock_get_file_size (const gchar *cFilePath)
 gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
 {
 	gboolean ret = TRUE;
+	cairo_dock_sync_keyfile (cFilePath);  // in case it's a conf file with pending changes
+	cairo_dock_sync_keyfile (cDestPath);  // don't let them overwrite the copy later
 	// open both files
 	int src_fd = open (cFilePath, O_RDONLY);
 	int dest_fd;
@@ -553,73 +561,209 @@ gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
  /// PID ///
 ///////////
 
-int cairo_dock_fm_get_pid (const gchar *cProcessName)
+// a process that has exited but has not been reaped by its parent yet still has its entry in /proc.
+static gboolean _process_is_zombie (const gchar *cPid)
 {
-	int iPID = -1;
-	gchar *cCommand = g_strdup_printf ("pidof %s", cProcessName);
-	gchar *cPID = cairo_dock_launch_command_sync (cCommand);
-
-	if (cPID != NULL && *cPID != '\0')
-		iPID = atoi (cPID);
+	gboolean bZombie = FALSE;
+	gchar *cContent = NULL;
+	gchar *cFilePath = g_strdup_printf ("/proc/%s/stat", cPid);
+	if (g_file_get_contents (cFilePath, &cContent, NULL, NULL))
+	{
+		const gchar *str = strrchr (cContent, ')');  // "pid (comm) state ...", and comm may contain spaces or parenthesis.
+		bZombie = (str != NULL && str[1] == ' ' && str[2] == 'Z');
+	}
+	g_free (cContent);
+	g_free (cFilePath);
+	return bZombie;
+}
 
-	g_free (cPID);
-	g_free (cCommand);
+static gboolean _process_has_name (const gchar *cPid, gchar **cNames)
+{
+	gboolean bFound = FALSE;
+	gchar *cFilePath, *cContent = NULL;
+	gsize length = 0;
+	int i;
+	
+	// the command line gives the name the program has been launched with (argv[0]), as a path or not.
+	cFilePath = g_strdup_printf ("/proc/%s/cmdline", cPid);
+	if (g_file_get_contents (cFilePath, &cContent, &length, NULL) && length != 0)
+	{
+		const gchar *cBaseName = strrchr (cContent, '/');  // stops at the end of argv[0].
+		cBaseName = (cBaseName ? cBaseName + 1 : cContent);
+		for (i = 0; cNames[i] != NULL && ! bFound; i ++)
+			bFound = (strcmp (cContent, cNames[i]) == 0 || strcmp (cBaseName, cNames[i]) == 0);
+	}
+	g_free (cContent);
+	g_free (cFilePath);
+	if (bFound)
+		return TRUE;
+	
+	// the name of the executable, limited to 15 chars (scripts and programs that changed their argv[0]).
+	cContent = NULL;
+	cFilePath = g_strdup_printf ("/proc/%s/comm", cPid);
+	if (g_file_get_contents (cFilePath, &cContent, NULL, NULL))
+	{
+		g_strchomp (cContent);
+		for (i = 0; cNames[i] != NULL && ! bFound; i ++)
+			bFound = (*cNames[i] != '\0' && strcmp (cContent, cNames[i]) == 0);
+	}
+	g_free (cContent);
+	g_free (cFilePath);
+	return bFound;
+}
 
+static int _get_pid (const gchar *cProcessName, int iExcludedPID)
+{
+	// same as 'pidof', but without spawning a shell: look for a running process with one of the given names in /proc.
+	GDir *dir = g_dir_open ("/proc", 0, NULL);
+	if (dir == NULL)
+		return -1;
+	
+	gchar **cNames = g_strsplit (cProcessName, " ", -1);
+	int iPID = -1;
+	const gchar *cPid;
+	while ((cPid = g_dir_read_name (dir)) != NULL)
+	{
+		if (! g_ascii_isdigit (*cPid) || atoi (cPid) == iExcludedPID)  // not a process, or the one we don't want
+			continue;
+		if (_process_has_name (cPid, cNames) && ! _process_is_zombie (cPid))  // a zombie is already gone (and a pidfd on it would be readable at once)
+		{
+			iPID = atoi (cPid);
+			break;
+		}
+	}
+	g_strfreev (cNames);
+	g_dir_close (dir);
+	
 	return iPID;
 }
 
-static gboolean _wait_pid (gpointer *pData)
+int cairo_dock_fm_get_pid (const gchar *cProcessName)
 {
-	gboolean bCheckSameProcess = GPOINTER_TO_INT (pData[0]);
-	gchar *cProcess = pData[1];
+	g_return_val_if_fail (cProcessName != NULL, -1);
+	return _get_pid (cProcessName, -1);
+}
 
-	// check if /proc/%d dir exists or the process is running
-	if ((bCheckSameProcess && ! g_file_test (cProcess, G_FILE_TEST_EXISTS))
-		|| (! bCheckSameProcess && cairo_dock_fm_get_pid (cProcess) == -1))
-	{
-		GSourceFunc pCallback = pData[2];
-		gpointer pUserData = pData[3];
+typedef struct {
+	gchar *cProcessName;
+	gboolean bCheckSameProcess;
+	int iPID;
+	GSourceFunc pCallback;
+	gpointer pUserData;
+	} CairoDockProcessWatch;
 
-		pCallback (pUserData);
+static GList *s_pPolledProcesses = NULL;  // processes that can't be watched with a pidfd
+static guint s_iSidPollProcesses = 0;
 
-		// free allocated ressources just used for this function
-		g_free (cProcess);
-		g_free (pData);
+static void _watch_process (CairoDockProcessWatch *pWatch);
 
-		return FALSE;
+static void _on_process_ended (CairoDockProcessWatch *pWatch)
+{
+	if (! pWatch->bCheckSameProcess)  // another process with this name may be running.
+	{
+		int iPID = _get_pid (pWatch->cProcessName, pWatch->iPID);  // the process that just ended may not be reaped yet
+		if (iPID != -1)
+		{
+			pWatch->iPID = iPID;
+			_watch_process (pWatch);
+			return;
+		}
 	}
+	
+	pWatch->pCallback (pWatch->pUserData);
+	
+	g_free (pWatch->cProcessName);
+	g_free (pWatch);
+}
 
-	return TRUE;
+static gboolean _process_is_running (int iPID)
+{
+	gchar *cPid = g_strdup_printf ("%d", iPID);
+	gchar *cProcDir = g_strdup_printf ("/proc/%s", cPid);
+	gboolean bRunning = g_file_test (cProcDir, G_FILE_TEST_EXISTS) && ! _process_is_zombie (cPid);
+	g_free (cProcDir);
+	g_free (cPid);
+	return bRunning;
 }
 
-gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSameProcess, GSourceFunc pCallback, gboolean bAlwaysLaunch, gpointer pUserData)
+static gboolean _poll_processes (G_GNUC_UNUSED gpointer data)
 {
-	int iPID = cairo_dock_fm_get_pid (cProcessName);
-	if (iPID == -1)
+	// check all the watched processes at once; the ones that are gone are handled after the list is updated, since they may be watched again.
+	GList *pEndedProcesses = NULL;
+	GList *p = s_pPolledProcesses, *next;
+	while (p != NULL)
 	{
-		if (bAlwaysLaunch)
-			pCallback (pUserData);
+		next = p->next;
+		CairoDockProcessWatch *pWatch = p->data;
+		if (! _process_is_running (pWatch->iPID))
+		{
+			s_pPolledProcesses = g_list_delete_link (s_pPolledProcesses, p);
+			pEndedProcesses = g_list_prepend (pEndedProcesses, pWatch);
+		}
+		p = next;
+	}
+	
+	g_list_foreach (pEndedProcesses, (GFunc)_on_process_ended, NULL);
+	g_list_free (pEndedProcesses);
+	
+	if (s_pPolledProcesses == NULL)
+	{
+		s_iSidPollProcesses = 0;
 		return FALSE;
 	}
+	return TRUE;
+}
 
-	gpointer *pData = g_new (gpointer, 4);
-	pData[0] = GINT_TO_POINTER (bCheckSameProcess);
-	if (bCheckSameProcess)
-		pData[1] = g_strdup_printf ("/proc/%d", iPID);
-	else
-		pData[1] = g_strdup (cProcessName);
-	pData[2] = pCallback;
-	pData[3] = pUserData;
+#ifdef HAVE_PIDFD_OPEN
+static gboolean _on_process_exit (gint fd, G_GNUC_UNUSED GIOCondition iCondition, CairoDockProcessWatch *pWatch)
+{
+	close (fd);
+	_on_process_ended (pWatch);
+	return FALSE;
+}
+#endif
 
-	/* It's not easy to be notified when a non child process is stopped...
+static void _watch_process (CairoDockProcessWatch *pWatch)
+{
+	#ifdef HAVE_PIDFD_OPEN
+	// a pidfd becomes readable as soon as the process exits, so we're notified immediately, even if it's not our child.
+	int fd = pidfd_open (pWatch->iPID, 0);
+	if (fd >= 0)
+	{
+		g_unix_fd_add (fd, G_IO_IN, (GUnixFDSourceFunc)_on_process_exit, pWatch);
+		return;
+	}
+	#endif
+	/* Without pidfd (old kernel or libc), it's not easy to be notified when a non child process is stopped...
 	 * We can't use waitpid (not a child process) or monitor /proc/PID dir (or a
 	 * file into it) with g_file_monitor, poll or inotify => it's not working...
 	 * And for apt-get/dpkg, we can't monitor the lock file with fcntl because
 	 * we need root rights to do that.
-	 * Let's just check every 5 seconds if the PID is still running
+	 * So let's just check every 5 seconds if the PIDs are still running, all at once.
 	 */
-	g_timeout_add_seconds (5, (GSourceFunc)_wait_pid, pData);
+	s_pPolledProcesses = g_list_prepend (s_pPolledProcesses, pWatch);
+	if (s_iSidPollProcesses == 0)
+		s_iSidPollProcesses = g_timeout_add_seconds (5, _poll_processes, NULL);
+}
 
+gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSameProcess, GSourceFunc pCallback, gboolean bAlwaysLaunch, gpointer pUserData)
+{
+	int iPID = cairo_dock_fm_get_pid (cProcessName);
+	if (iPID == -1)
+	{
+		if (bAlwaysLaunch)
+			pCallback (pUserData);
+		return FALSE;
+	}
+	
+	CairoDockProcessWatch *pWatch = g_new0 (CairoDockProcessWatch, 1);
+	pWatch->cProcessName = g_strdup (cProcessName);
+	pWatch->bCheckSameProcess = bCheckSameProcess;
+	pWatch->iPID = iPID;
+	pWatch->pCallback = pCallback;
+	pWatch->pUserData = pUserData;
+	_watch_process (pWatch);
+	
 	return TRUE;
 }
 
@@ -258,8 +258,8 @@ int cairo_dock_get_file_size (const gchar *cFilePath);
 gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath);
 
 
-/** Get process ID given its name
- * @param cProcessName name of the process
+/** Get process ID given its name, like 'pidof' does (but without launching it).
+ * @param cProcessName name of the process, or several names separated by spaces
  * @return the PID if it exists or -1
  */
 int cairo_dock_fm_get_pid (const gchar *cProcessName);
@@ -269,7 +269,7 @@ int cairo_dock_fm_get_pid (const gchar *cProcessName);
  * @param bCheckSameProcess TRUE to check if first match is running. FALSE to
  *        check every time if this process name is running even if it's not the
  *        same PID.
- * @param pCallback function to call when the process is no longer running
+ * @param pCallback function to call when the process is no longer running (immediately if the system supports pidfd, otherwise within 5 seconds)
  * @param bAlwaysLaunch TRUE to launch the callback function even if the process
  *        is not running or if there is an error
  * @param pUserData data to pass to pCallback
@@ -0,0 +1,257 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <GL/gl.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-opengl.h"  // g_openglConfig
+#include "cairo-dock-image-buffer.h"
+#include "cairo-dock-icon-atlas.h"
+
+extern CairoDockGLConfig g_openglConfig;
+extern gboolean g_bEasterEggs;
+
+#define CAIRO_DOCK_ICON_ATLAS_MAX_SIZE 2048
+#define CAIRO_DOCK_ICON_ATLAS_GAP 1  // empty pixels between 2 images, so that they don't bleed on each other when the texture is interpolated.
+
+// location of an image in the atlas
+typedef struct {
+	gint x, y, w, h;
+	guint iRevision;  // revision of the image when it was copied
+	} CairoDockAtlasSlot;
+
+static GLuint s_iAtlasTexture = 0;
+static GLuint s_iAtlasFbo = 0;
+static gint s_iAtlasSize = 0;
+static GHashTable *s_hSlots = NULL;  // texture of an image -> its slot
+static gint s_iRowX = 0;  // position of the next image in the current row
+static gint s_iRowY = 0;  // top of the current row
+static gint s_iRowHeight = 0;  // height of the highest image in the current row
+static gboolean s_bFull = FALSE;  // an image didn't fit during the current frame
+static gint s_iNbFramesSinceClear = 0;
+static gboolean s_bNoMoreClear = FALSE;  // the icons don't fit even in an empty atlas, so emptying it would only make us copy them again at each frame.
+
+
+// attach a texture to our FBO, and return the previously bound framebuffer, or -1 if the FBO couldn't be used.
+static GLint _bind_fbo_on_texture (GLuint iTexture)
+{
+	GLint iPrevFramebuffer = 0;
+	glGetIntegerv (GL_FRAMEBUFFER_BINDING_EXT, &iPrevFramebuffer);
+	glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, s_iAtlasFbo);
+	glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT,
+		GL_COLOR_ATTACHMENT0_EXT,
+		GL_TEXTURE_2D,
+		iTexture,
+		0);
+	if (glCheckFramebufferStatusEXT (GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
+	{
+		glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, 0, 0);
+		glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, iPrevFramebuffer);
+		return -1;
+	}
+	return iPrevFramebuffer;
+}
+
+static void _unbind_fbo (GLint iPrevFramebuffer)
+{
+	glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, 0, 0);
+	glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, iPrevFramebuffer);
+}
+
+static void _clear_atlas (void)
+{
+	GLint iPrevFramebuffer = _bind_fbo_on_texture (s_iAtlasTexture);
+	if (iPrevFramebuffer >= 0)
+	{
+		glPushAttrib (GL_COLOR_BUFFER_BIT | GL_SCISSOR_BIT);
+		glDisable (GL_SCISSOR_TEST);
+		glClearColor (0., 0., 0., 0.);
+		glClear (GL_COLOR_BUFFER_BIT);
+		glPopAttrib ();
+		_unbind_fbo (iPrevFramebuffer);
+	}
+	g_hash_table_remove_all (s_hSlots);
+	s_iRowX = s_iRowY = s_iRowHeight = 0;
+	s_bFull = FALSE;
+	s_iNbFramesSinceClear = 0;
+}
+
+static gboolean _create_atlas (void)
+{
+	GLint iMaxTextureSize = 0;
+	glGetIntegerv (GL_MAX_TEXTURE_SIZE, &iMaxTextureSize);
+	s_iAtlasSize = MIN (iMaxTextureSize, CAIRO_DOCK_ICON_ATLAS_MAX_SIZE);
+	if (s_iAtlasSize <= 0)
+		return FALSE;
+	
+	glGenFramebuffersEXT (1, &s_iAtlasFbo);
+	glGenTextures (1, &s_iAtlasTexture);
+	glBindTexture (GL_TEXTURE_2D, s_iAtlasTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D (GL_TEXTURE_2D, 0, GL_RGBA, s_iAtlasSize, s_iAtlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	
+	s_hSlots = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	_clear_atlas ();
+	cd_debug ("icons atlas: %dx%d", s_iAtlasSize, s_iAtlasSize);
+	return TRUE;
+}
+
+gboolean cairo_dock_icon_atlas_begin (void)
+{
+	if (! g_openglConfig.bFboAvailable || g_bEasterEggs)  // with mipmaps, the images couldn't be copied as they are.
+		return FALSE;
+	if (s_iAtlasTexture == 0 && ! _create_atlas ())
+		return FALSE;
+	if (s_bFull && ! s_bNoMoreClear)
+	{
+		if (s_iNbFramesSinceClear <= 1)  // it was filled by the first frame after being emptied: keep it as it is, the icons that don't fit will be drawn one by one.
+		{
+			cd_debug ("icons atlas is too small for the icons, don't empty it any more");
+			s_bNoMoreClear = TRUE;
+		}
+		else
+		{
+			cd_debug ("icons atlas is full, empty it");
+			_clear_atlas ();
+		}
+	}
+	s_iNbFramesSinceClear ++;
+	return TRUE;
+}
+
+// find room for an image in the current row, or in a new row.
+static gboolean _alloc_slot (CairoDockAtlasSlot *pSlot, gint w, gint h)
+{
+	if (w > s_iAtlasSize || h > s_iAtlasSize)
+		return FALSE;
+	if (s_iRowX + w > s_iAtlasSize)
+	{
+		s_iRowY += s_iRowHeight + CAIRO_DOCK_ICON_ATLAS_GAP;
+		s_iRowX = 0;
+		s_iRowHeight = 0;
+	}
+	if (s_iRowY + h > s_iAtlasSize)
+		return FALSE;
+	pSlot->x = s_iRowX;
+	pSlot->y = s_iRowY;
+	pSlot->w = w;
+	pSlot->h = h;
+	s_iRowX += w + CAIRO_DOCK_ICON_ATLAS_GAP;
+	s_iRowHeight = MAX (s_iRowHeight, h);
+	return TRUE;
+}
+
+static gboolean _copy_image (CairoDockImageBuffer *pImage, CairoDockAtlasSlot *pSlot)
+{
+	GLint iPrevFramebuffer = _bind_fbo_on_texture (pImage->iTexture);
+	if (iPrevFramebuffer < 0)
+		return FALSE;
+	glBindTexture (GL_TEXTURE_2D, s_iAtlasTexture);
+	glCopyTexSubImage2D (GL_TEXTURE_2D, 0, pSlot->x, pSlot->y, 0, 0, pSlot->w, pSlot->h);  // the texture is read as it is, so it keeps its orientation.
+	glBindTexture (GL_TEXTURE_2D, 0);
+	_unbind_fbo (iPrevFramebuffer);
+	pSlot->iRevision = pImage->iRevision;
+	return TRUE;
+}
+
+// the real size of a texture: it's the size of the surface in pixels, which differs from the size of the image buffer on HiDPI screens, or when the texture had to be stretched to a power of 2.
+static void _get_texture_size (GLuint iTexture, gint *iWidth, gint *iHeight)
+{
+	GLint w = 0, h = 0;
+	glBindTexture (GL_TEXTURE_2D, iTexture);
+	glGetTexLevelParameteriv (GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+	glGetTexLevelParameteriv (GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	*iWidth = w;
+	*iHeight = h;
+}
+
+gboolean cairo_dock_icon_atlas_get_image_coords (CairoDockImageBuffer *pImage, GLfloat *pCoords)
+{
+	g_return_val_if_fail (s_iAtlasTexture != 0 && pImage->iTexture != 0, FALSE);
+	if (pImage->bExternalTexture)  // its content can change at any time (ex.: a window's texture is updated on damage), so a copy would be frozen.
+		return FALSE;
+	
+	CairoDockAtlasSlot *pSlot = g_hash_table_lookup (s_hSlots, GUINT_TO_POINTER (pImage->iTexture));
+	if (pSlot == NULL || pSlot->iRevision != pImage->iRevision)  // new or modified image: copy the whole texture, the quad will map it on the size of the icon.
+	{
+		gint w, h;
+		_get_texture_size (pImage->iTexture, &w, &h);
+		if (w <= 0 || h <= 0)
+			return FALSE;
+		if (pSlot != NULL && (w > pSlot->w || h > pSlot->h))  // the image has grown, its place is lost until the atlas is emptied.
+		{
+			g_hash_table_remove (s_hSlots, GUINT_TO_POINTER (pImage->iTexture));
+			pSlot = NULL;
+		}
+		if (pSlot == NULL)
+		{
+			CairoDockAtlasSlot slot;
+			if (! _alloc_slot (&slot, w, h))
+			{
+				s_bFull = TRUE;
+				return FALSE;
+			}
+			if (! _copy_image (pImage, &slot))
+				return FALSE;
+			pSlot = g_memdup2 (&slot, sizeof (CairoDockAtlasSlot));
+			g_hash_table_insert (s_hSlots, GUINT_TO_POINTER (pImage->iTexture), pSlot);
+		}
+		else  // same size or smaller, keep its place.
+		{
+			pSlot->w = w;
+			pSlot->h = h;
+			if (! _copy_image (pImage, pSlot))
+			{
+				g_hash_table_remove (s_hSlots, GUINT_TO_POINTER (pImage->iTexture));
+				return FALSE;
+			}
+		}
+	}
+	
+	pCoords[0] = (GLfloat) pSlot->x / s_iAtlasSize;
+	pCoords[1] = (GLfloat) pSlot->y / s_iAtlasSize;
+	pCoords[2] = (GLfloat) (pSlot->x + pSlot->w) / s_iAtlasSize;
+	pCoords[3] = (GLfloat) (pSlot->y + pSlot->h) / s_iAtlasSize;
+	return TRUE;
+}
+
+GLuint cairo_dock_icon_atlas_get_texture (void)
+{
+	return s_iAtlasTexture;
+}
+
+void cairo_dock_icon_atlas_destroy (void)
+{
+	if (s_iAtlasTexture == 0)
+		return;
+	glDeleteTextures (1, &s_iAtlasTexture);
+	s_iAtlasTexture = 0;
+	glDeleteFramebuffersEXT (1, &s_iAtlasFbo);
+	s_iAtlasFbo = 0;
+	g_hash_table_destroy (s_hSlots);
+	s_hSlots = NULL;
+	s_iAtlasSize = 0;
+	s_iRowX = s_iRowY = s_iRowHeight = 0;
+	s_bFull = FALSE;
+	s_iNbFramesSinceClear = 0;
+	s_bNoMoreClear = FALSE;
+}
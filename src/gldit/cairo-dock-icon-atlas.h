@@ -0,0 +1,61 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CAIRO_DOCK_ICON_ATLAS__
+#define  __CAIRO_DOCK_ICON_ATLAS__
+
+#include <glib.h>
+#include <GL/gl.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-icon-atlas.h This class implements a texture atlas for the images of the icons.
+* The textures of the icons are copied into a single big texture, so that many icons can be drawn with a single draw call (see \ref cairo_dock_render_icons_batch_opengl).
+*
+* A copy is identified by the texture and the revision of its image buffer, so it is updated as soon as the image is modified through the functions of the image buffer (or after a call to \ref cairo_dock_image_buffer_texture_modified).
+* Images whose texture is given from outside (\ref cairo_dock_load_image_buffer_from_texture, like the texture of a window) are never copied, since their content can change without the revision being bumped; they are drawn with their own texture.
+* The whole texture is copied, with its real size in pixels (which is not the size of the image buffer on a HiDPI screen, or when the texture had to be stretched to a power of 2).
+* The images are packed in rows; when the atlas is full, it is emptied at the beginning of the next batch and the images are copied again as they are drawn. If it's full again right after being emptied, the icons of a frame can't fit in it, so it is not emptied any more until it's destroyed (when the icons are reloaded), and the images that don't fit are drawn with their own texture. The copies are done with an FBO, so the atlas is not available without FBO support.
+*/
+
+/** Start using the atlas, for one frame. It creates the atlas if needed, and empties it if it became full during the previous frame (unless it became full right after being emptied). It must be called with an OpenGL context current.
+*@return TRUE if the atlas can be used.
+*/
+gboolean cairo_dock_icon_atlas_begin (void);
+
+/** Get the location of an image in the atlas, copying it there if it's not yet in it or if it has been modified since. \ref cairo_dock_icon_atlas_begin must have been called before.
+*@param pImage an image buffer, with a texture.
+*@param pCoords filled with the texture coordinates of the image in the atlas: u0, v0, u1, v1.
+*@return TRUE if the image is in the atlas, FALSE if it doesn't fit or its texture is an external one (in which case it has to be drawn with its own texture).
+*/
+gboolean cairo_dock_icon_atlas_get_image_coords (CairoDockImageBuffer *pImage, GLfloat *pCoords);
+
+/** Get the texture of the atlas.
+*@return the texture, or 0 if the atlas has not been created yet.
+*/
+GLuint cairo_dock_icon_atlas_get_texture (void);
+
+/** Destroy the atlas and free its resources. It will be created again the next time it's used.
+*/
+void cairo_dock_icon_atlas_destroy (void);
+
+G_END_DECLS
+#endif
@@ -37,6 +37,7 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-overlay.h"
+#include "cairo-dock-icon-manager.h"  // cairo_dock_load_icon_image_async
 #include "cairo-dock-icon-factory.h"
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
@@ -196,8 +197,10 @@ void cairo_dock_load_icon_text (Icon *icon)
 	}
 	
 	int iWidth, iHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
+	cairo_surface_t *pSurface = cairo_dock_get_text_surface ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
 		&myIconsParam.iconTextDescription,
+		1.,
+		0,
 		&iWidth,
 		&iHeight);
 	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
@@ -218,7 +221,7 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
 		int w, h;
-		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
+		cairo_surface_t *pSurface = cairo_dock_get_text_surface (icon->cQuickInfo,  // quick-infos often take the same values again (percentages, etc), so don't render them each time
 			&myIconsParam.quickInfoTextDescription,
 			fMaxScale,
 			iWidth,  // limit the text to the width of the icon
@@ -278,7 +281,8 @@ void cairo_dock_trigger_load_icon_buffers (Icon *pIcon)
 	if (pIcon->iSidLoadImage == 0)
 	{
 		cairo_dock_load_icon_text (pIcon);  // la vue peut avoir besoin de connaitre la taille du texte.
-		pIcon->iSidLoadImage = g_idle_add ((GSourceFunc)_load_icon_buffer_idle, pIcon);
+		if (! cairo_dock_load_icon_image_async (pIcon))  // decode the image in a thread if possible, so that a mass reload doesn't freeze the docks.
+			pIcon->iSidLoadImage = g_idle_add ((GSourceFunc)_load_icon_buffer_idle, pIcon);
 	}
 }
 
@@ -175,6 +175,7 @@ struct _Icon {
 	gint iThumbnailWidth, iThumbnailHeight;
 	
 	gboolean bIsLaunching;  // a mere recopy of gldi_class_is_starting()
+	gboolean bDrawnInBatch;  // TRUE when the icon has just been drawn by cairo_dock_render_icons_batch_opengl(), until it is finished by cairo_dock_render_one_icon_opengl().
 	gpointer reserved[4];
 };
 
@@ -32,6 +32,7 @@
 #include "cairo-dock-class-manager.h"  // cairo_dock_deinhibite_class
 #include "cairo-dock-draw.h"  // cairo_dock_render_icon_notification
 #include "cairo-dock-draw-opengl.h"  // cairo_dock_destroy_icon_fbo
+#include "cairo-dock-icon-atlas.h"  // cairo_dock_icon_atlas_destroy
 #include "cairo-dock-container.h"
 #include "cairo-dock-dock-manager.h"  // gldi_icons_foreach_in_docks
 #include "cairo-dock-dialog-manager.h"  // cairo_dock_remove_dialog_if_any
@@ -49,6 +50,7 @@
 #include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-backends-manager.h"  // cairo_dock_foreach_icon_container_renderer
 #include "cairo-dock-style-manager.h"
+#include "cairo-dock-image-cache.h"  // cairo_dock_image_cache_clear
 #define _MANAGER_DEF_
 #include "cairo-dock-icon-manager.h"
 
@@ -72,10 +74,15 @@ static GtkIconTheme *s_pIconTheme = NULL;
 static gboolean s_bUseLocalIcons = FALSE;
 static gboolean s_bUseDefaultTheme = TRUE;
 static guint s_iSidReloadTheme = 0;
+static GHashTable *s_pIconPathCache = NULL;  // "name size scale local" -> path, or NULL if not found
 
 static void _cairo_dock_unload_icon_textures (void);
 static void _cairo_dock_unload_icon_theme (void);
 static void _on_icon_theme_changed (GtkIconTheme *pIconTheme, gpointer data);
+static void _load_image (Icon *icon);
+static gboolean _on_images_loaded_idle (gpointer data);
+static void _cancel_pending_load (Icon *icon);
+static void _cancel_all_pending_loads (void);
 
 
 void gldi_icons_foreach (GldiIconFunc pFunction, gpointer pUserData)
@@ -223,24 +230,20 @@ gint cairo_dock_search_icon_size (GtkIconSize iIconSize)
 
 extern GldiContainer *g_pPrimaryContainer;
 
-gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+static gint _get_icon_scale (void)
 {
-	g_return_val_if_fail (cFileName != NULL, NULL);
-	
-	//\_______________________ easy cases: we receive a path.
-	if (*cFileName == '~')
-	{
-		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
-	}
-	
-	if (*cFileName == '/')
+	gint scale = 1;
+	if (g_pPrimaryContainer != NULL)
 	{
-		return g_strdup (cFileName);
+		// TODO: better way to determine the scale factor based on which screen this icon will appear !!
+		GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
+		scale = gdk_window_get_scale_factor (gdkwindow);
 	}
-	
-	//\_______________________ check for the presence of suffix and version number.
-	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
-	
+	return scale;
+}
+
+static gchar *_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize, gint scale)
+{
 	GString *sIconPath = g_string_new ("");
 	const gchar *cSuffixTab[4] = {".svg", ".png", ".xpm", NULL};
 	gboolean bHasSuffix=FALSE, bFileFound=FALSE, bHasVersion=FALSE;
@@ -296,13 +299,6 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 				*str = '\0';
 		}
 
-		gint scale = 1;
-		if (g_pPrimaryContainer != NULL)
-		{
-			// TODO: better way to determine the scale factor based on which screen this icon will appear !!
-			GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
-			scale = gdk_window_get_scale_factor (gdkwindow);
-		}
 		pIconInfo = gtk_icon_theme_lookup_icon_for_scale (s_pIconTheme,
 			sIconPath->str,
 			iDesiredIconSize, // GTK_ICON_LOOKUP_FORCE_SIZE if size < 30 ?? -> icons can be different // a lot of themes now use only svg files.
@@ -358,8 +354,50 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 	return g_string_free (sIconPath, FALSE);
 }
 
+gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+{
+	g_return_val_if_fail (cFileName != NULL, NULL);
+	
+	//\_______________________ easy cases: we receive a path.
+	if (*cFileName == '~')
+	{
+		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
+	}
+	
+	if (*cFileName == '/')
+	{
+		return g_strdup (cFileName);
+	}
+	
+	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
+	
+	//\_______________________ look in the results of the previous searches (found or not), to not probe the disk and the icon theme each time an icon is (re)loaded.
+	gint scale = _get_icon_scale ();
+	gchar *cKey = g_strdup_printf ("%s %d %d %d", cFileName, iDesiredIconSize, scale, s_bUseLocalIcons);
+	gchar *cPath = NULL;
+	if (s_pIconPathCache != NULL && g_hash_table_lookup_extended (s_pIconPathCache, cKey, NULL, (gpointer*)&cPath))
+	{
+		g_free (cKey);
+		return g_strdup (cPath);
+	}
+	
+	cPath = _search_icon_s_path (cFileName, iDesiredIconSize, scale);
+	
+	if (s_pIconPathCache == NULL)
+		s_pIconPathCache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	g_hash_table_insert (s_pIconPathCache, cKey, g_strdup (cPath));  // takes the key
+	return cPath;
+}
+
+void cairo_dock_reset_icon_path_cache (void)
+{
+	if (s_pIconPathCache != NULL)
+		g_hash_table_remove_all (s_pIconPathCache);
+}
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 {
+	cairo_dock_reset_icon_path_cache ();
 	if (s_bUseDefaultTheme)
 	{
 		g_signal_handlers_block_matched (s_pIconTheme,
@@ -381,6 +419,7 @@ void cairo_dock_remove_path_from_icon_theme (const gchar *cThemePath)
 {
 	if (! GTK_IS_ICON_THEME (s_pIconTheme))
 		return;
+	cairo_dock_reset_icon_path_cache ();
 	g_signal_handlers_block_matched (s_pIconTheme,
 		(GSignalMatchType) G_SIGNAL_MATCH_FUNC,
 		0, 0, NULL, _on_icon_theme_changed, NULL);
@@ -691,6 +730,8 @@ static gboolean _on_icon_theme_changed_idle (G_GNUC_UNUSED gpointer data)
 static void _on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
 {
 	cd_message ("theme has changed");
+	cairo_dock_reset_icon_path_cache ();  // icons may have appeared or disappeared
+	cairo_dock_image_cache_clear ();  // the images may have been replaced without their path or date changing (ex.: a theme re-installed)
 	// Reload the icons in idle, because this signal is triggered directly by 'gtk_icon_theme_set_search_path()'; so we may end reloading an applet in the middle of its work (ex.: Status-Notifier when the watcher terminates)
 	if (s_iSidReloadTheme == 0)
 		s_iSidReloadTheme = g_idle_add (_on_icon_theme_changed_idle, NULL);
@@ -698,6 +739,7 @@ static void _on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GN
 static void _cairo_dock_load_icon_theme (void)
 {
 	g_return_if_fail (s_pIconTheme == NULL);
+	cairo_dock_reset_icon_path_cache ();  // also covers a change of the local icons (new theme)
 	if (myIconsParam.cIconTheme == NULL  // no icon theme defined => use the default one.
 	|| strcmp (myIconsParam.cIconTheme, "_Custom Icons_") == 0)  // use custom icons and default theme as fallback
 	{
@@ -794,6 +836,7 @@ static void reload (CairoIconsParam *pPrevIcons, CairoIconsParam *pIcons)
 	gboolean bThemeChanged = (g_strcmp0 (pIcons->cIconTheme, pPrevIcons->cIconTheme) != 0);
 	if (bThemeChanged)
 	{
+		cairo_dock_image_cache_clear ();
 		_cairo_dock_unload_icon_theme ();
 		
 		_cairo_dock_load_icon_theme ();
@@ -811,6 +854,7 @@ static void reload (CairoIconsParam *pPrevIcons, CairoIconsParam *pIcons)
 	///cairo_dock_create_icon_pbuffer ();
 	cairo_dock_destroy_icon_fbo ();
 	cairo_dock_create_icon_fbo ();
+	cairo_dock_icon_atlas_destroy ();  // the size of the icons may have changed, start with an empty atlas
 	
 	if (pPrevIcons->iIconWidth != pIcons->iIconWidth ||
 		pPrevIcons->iIconHeight != pIcons->iIconHeight ||
@@ -873,12 +917,16 @@ static void _cairo_dock_unload_icon_theme (void)
 	else
 		g_object_unref (s_pIconTheme);
 	s_pIconTheme = NULL;
+	cairo_dock_reset_icon_path_cache ();
 }
 static void unload (void)
 {
+	_cancel_all_pending_loads ();
+	
 	_cairo_dock_unload_icon_textures ();
 	
 	cairo_dock_destroy_icon_fbo ();
+	cairo_dock_icon_atlas_destroy ();
 	
 	_cairo_dock_delete_floating_icons ();
 	
@@ -935,6 +983,8 @@ static gboolean on_style_changed (G_GNUC_UNUSED gpointer data)
 
 static void init (void)
 {
+	cairo_dock_image_cache_init ();
+	
 	gldi_object_register_notification (&myDesktopMgr,
 		NOTIFICATION_DESKTOP_CHANGED,
 		(GldiNotificationFunc) _on_change_current_desktop_viewport_notification,
@@ -953,13 +1003,196 @@ static void init (void)
  /// MANAGER ///
 ///////////////
 
+  ////////////////////////
+ /// ASYNCHRONOUS LOAD ///
+////////////////////////
+
+#define CAIRO_DOCK_MAX_PENDING_IMAGE_LOADS 64  // beyond that, images are loaded on the main thread as before, so that a mass reload doesn't pile up jobs.
+#define CAIRO_DOCK_MAX_IMAGE_LOAD_THREADS 4
+
+// the worker only uses the fields below, which are all filled in the main thread before the job is pushed (the icon theme and the widgets can't be used from the worker).
+typedef struct {
+	Icon *pIcon;  // only used as a key, the icon may have been destroyed when the job is finished.
+	gchar *cImagePath;  // absolute path, resolved with the icon theme
+	gint iWidth;
+	gint iHeight;
+	gdouble fScale;  // device scale of the screen, read from the main container
+	cairo_surface_t *pSurface;
+	gint bCancelled;
+	gboolean bDone;
+} CairoIconLoadJob;
+
+static GThreadPool *s_pImageLoadPool = NULL;
+static GHashTable *s_pPendingLoads = NULL;  // icon -> its current job
+static GAsyncQueue *s_pFinishedLoads = NULL;
+static gint s_iNbPendingLoads = 0;
+static gint s_bFinishedLoadsIdle = 0;
+
+static void _free_load_job (CairoIconLoadJob *pJob)
+{
+	if (pJob->pSurface != NULL)
+		cairo_surface_destroy (pJob->pSurface);
+	g_free (pJob->cImagePath);
+	g_free (pJob);
+}
+
+static void _cancel_pending_load (Icon *icon)
+{
+	CairoIconLoadJob *pJob;
+	if (s_pPendingLoads != NULL && (pJob = g_hash_table_lookup (s_pPendingLoads, icon)) != NULL)
+	{
+		g_atomic_int_set (&pJob->bCancelled, 1);  // the job will be freed when it comes back
+		g_hash_table_remove (s_pPendingLoads, icon);
+	}
+}
+
+// take the decoded surface of an icon, if it's ready and at the right size; otherwise the icon is loaded as usual.
+static cairo_surface_t *_take_loaded_surface (Icon *icon, int iWidth, int iHeight)
+{
+	CairoIconLoadJob *pJob = (s_pPendingLoads != NULL ? g_hash_table_lookup (s_pPendingLoads, icon) : NULL);
+	if (pJob == NULL)
+		return NULL;
+	cairo_surface_t *pSurface = NULL;
+	if (pJob->bDone && pJob->iWidth == iWidth && pJob->iHeight == iHeight)
+	{
+		pSurface = pJob->pSurface;
+		pJob->pSurface = NULL;
+		g_hash_table_remove (s_pPendingLoads, icon);  // the job is freed by the caller
+	}
+	else  // a synchronous load overtakes the job
+	{
+		_cancel_pending_load (icon);
+	}
+	return pSurface;
+}
+
+static void _decode_image (CairoIconLoadJob *pJob, G_GNUC_UNUSED gpointer data)
+{
+	if (! g_atomic_int_get (&pJob->bCancelled))
+		pJob->pSurface = cairo_dock_create_image_surface_from_image_simple (pJob->cImagePath,
+			pJob->iWidth,
+			pJob->iHeight,
+			pJob->fScale);
+	
+	g_async_queue_push (s_pFinishedLoads, pJob);
+	if (g_atomic_int_compare_and_exchange (&s_bFinishedLoadsIdle, 0, 1))  // one wake-up for all the jobs that finish meanwhile
+		g_idle_add ((GSourceFunc) _on_images_loaded_idle, NULL);
+}
+
+static gboolean _on_images_loaded_idle (G_GNUC_UNUSED gpointer data)
+{
+	g_atomic_int_set (&s_bFinishedLoadsIdle, 0);  // reset it before emptying the queue, so that no job can be forgotten
+	CairoIconLoadJob *pJob;
+	Icon *icon;
+	while ((pJob = g_async_queue_try_pop (s_pFinishedLoads)) != NULL)
+	{
+		s_iNbPendingLoads --;
+		icon = pJob->pIcon;
+		if (g_atomic_int_get (&pJob->bCancelled) || g_hash_table_lookup (s_pPendingLoads, icon) != pJob)  // obsolete job, or the icon has been destroyed
+		{
+			_free_load_job (pJob);
+			continue;
+		}
+		if (icon->pContainer == NULL)
+		{
+			g_hash_table_remove (s_pPendingLoads, icon);
+			_free_load_job (pJob);
+			continue;
+		}
+		
+		// in cairo mode, surfaces are similar to the screen for a faster drawing, so copy the pixels into such a surface.
+		if (pJob->pSurface != NULL && ! g_bUseOpenGL)
+		{
+			cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (pJob->iWidth, pJob->iHeight);
+			cairo_t *pCairoContext = cairo_create (pNewSurface);
+			cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+			cairo_set_source_surface (pCairoContext, pJob->pSurface, 0, 0);
+			cairo_paint (pCairoContext);
+			cairo_destroy (pCairoContext);
+			cairo_surface_destroy (pJob->pSurface);
+			pJob->pSurface = pNewSurface;
+		}
+		pJob->bDone = TRUE;
+		
+		// load the image buffer; '_load_image' will take the surface of the job (and the texture is made here, in the main thread).
+		cairo_dock_load_icon_image (icon, icon->pContainer);
+		_cancel_pending_load (icon);  // in case it has not been consumed (the size changed in the meantime)
+		_free_load_job (pJob);
+		
+		if (cairo_dock_get_icon_data_renderer (icon) != NULL)
+			cairo_dock_refresh_data_renderer (icon, icon->pContainer);
+		cairo_dock_load_icon_quickinfo (icon);
+		cairo_dock_redraw_icon (icon);
+	}
+	return FALSE;
+}
+
+gboolean cairo_dock_load_icon_image_async (Icon *icon)
+{
+	if (icon->iface.load_image != _load_image  // only the generic loader can run in a thread
+	|| icon->cFileName == NULL
+	|| icon->pContainer == NULL
+	|| s_iNbPendingLoads >= CAIRO_DOCK_MAX_PENDING_IMAGE_LOADS)
+		return FALSE;
+	int iWidth = cairo_dock_icon_get_allocated_width (icon);
+	int iHeight = cairo_dock_icon_get_allocated_height (icon);
+	if (iWidth <= 0 || iHeight <= 0)
+		return FALSE;
+	
+	// the path is resolved here, the icon theme can't be used outside of the main thread.
+	gchar *cIconPath = cairo_dock_search_icon_s_path (icon->cFileName, MAX (iWidth, iHeight));
+	if (cIconPath == NULL || *cIconPath != '/')  // let the synchronous load handle the default image
+	{
+		g_free (cIconPath);
+		return FALSE;
+	}
+	
+	if (s_pImageLoadPool == NULL)
+	{
+		s_pImageLoadPool = g_thread_pool_new ((GFunc) _decode_image,
+			NULL,
+			MIN (CAIRO_DOCK_MAX_IMAGE_LOAD_THREADS, (gint)g_get_num_processors ()),
+			FALSE,
+			NULL);
+		s_pPendingLoads = g_hash_table_new (g_direct_hash, g_direct_equal);
+		s_pFinishedLoads = g_async_queue_new ();
+	}
+	
+	_cancel_pending_load (icon);  // a new load supersedes the previous one
+	
+	CairoIconLoadJob *pJob = g_new0 (CairoIconLoadJob, 1);
+	pJob->pIcon = icon;
+	pJob->cImagePath = cIconPath;
+	pJob->iWidth = iWidth;
+	pJob->iHeight = iHeight;
+	pJob->fScale = _get_icon_scale ();
+	g_hash_table_insert (s_pPendingLoads, icon, pJob);
+	s_iNbPendingLoads ++;
+	g_thread_pool_push (s_pImageLoadPool, pJob, NULL);  // meanwhile, the icon keeps drawing its current image (or nothing if it has none yet).
+	return TRUE;
+}
+
+static void _cancel_all_pending_loads (void)
+{
+	if (s_pPendingLoads == NULL)
+		return;
+	GHashTableIter iter;
+	gpointer value;
+	g_hash_table_iter_init (&iter, s_pPendingLoads);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+	{
+		g_atomic_int_set (&((CairoIconLoadJob*)value)->bCancelled, 1);
+		g_hash_table_iter_remove (&iter);
+	}
+}
+
 static void _load_image (Icon *icon)
 {
 	int iWidth = cairo_dock_icon_get_allocated_width (icon);
 	int iHeight = cairo_dock_icon_get_allocated_height (icon);
-	cairo_surface_t *pSurface = NULL;
+	cairo_surface_t *pSurface = _take_loaded_surface (icon, iWidth, iHeight);
 	
-	if (icon->cFileName)
+	if (pSurface == NULL && icon->cFileName)
 	{
 		gchar *cIconPath = cairo_dock_search_icon_s_path (icon->cFileName, MAX (iWidth, iHeight));
 		if (cIconPath != NULL && *cIconPath != '\0')
@@ -1007,6 +1240,7 @@ static void reset_object (GldiObject *obj)
 		g_source_remove (icon->iSidRedrawSubdockContent);
 	if (icon->iSidLoadImage != 0)  // remove timers after any function that could trigger one (for instance, cairo_dock_deinhibite_class calls cairo_dock_trigger_load_icon_buffers)
 		g_source_remove (icon->iSidLoadImage);
+	_cancel_pending_load (icon);
 	if (icon->iSidDoubleClickDelay != 0)
 		g_source_remove (icon->iSidDoubleClickDelay);
 	
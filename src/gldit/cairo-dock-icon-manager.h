@@ -126,12 +126,24 @@ void cairo_dock_set_specified_desktop_for_icon (Icon *pIcon, int iSpecificDeskto
 gint cairo_dock_search_icon_size (GtkIconSize iIconSize);
 
 /** Search the path of an icon into the defined icons themes. It also handles the '~' caracter in paths.
+ * Results (including failures) are remembered until the icon theme or its search paths change, so it is cheap to call it repeatedly. It must be called from the main thread.
  * @param cFileName name of the icon file.
  * @param iDesiredIconSize desired icon size if we use icons from user icons theme.
  * @return the complete path of the icon, or NULL if not found.
  */
 gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize);
 
+/** Load the image of an icon in a worker thread. The image is decoded and scaled in the background, then it is loaded into the icon (and its texture) from the main loop, and the icon is redrawn; meanwhile the icon keeps its current image.
+ * Only icons using the generic image loader (launchers, user icons) can be loaded this way, and only a limited number of loads can be pending at once.
+ * @param icon the icon
+ * @return TRUE if the load has been scheduled, FALSE if the icon has to be loaded the usual way.
+ */
+gboolean cairo_dock_load_icon_image_async (Icon *icon);
+
+/** Forget the results of the previous icon searches. Call it after adding or removing an icon file in a searched directory (like the custom icons of the current theme), so that the next search sees the change.
+ */
+void cairo_dock_reset_icon_path_cache (void);
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cPath);
 
 void cairo_dock_remove_path_from_icon_theme (const gchar *cPath);
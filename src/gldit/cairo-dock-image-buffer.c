@@ -86,6 +86,7 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 {
 	if (cImageFile == NULL)
 		return;
+	pImage->bExternalTexture = FALSE;
 	gchar *cImagePath = cairo_dock_search_image_s_path (cImageFile);
 	double w=0, h=0;
 	pImage->pSurface = cairo_dock_create_surface_from_image (
@@ -150,7 +151,10 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 	}
 	
 	if (g_bUseOpenGL)
+	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+		cairo_dock_image_buffer_texture_modified (pImage);
+	}
 	
 	g_free (cImagePath);
 }
@@ -163,21 +167,27 @@ void cairo_dock_load_image_buffer_from_surface (CairoDockImageBuffer *pImage, ca
 		pSurface = NULL;
 	}
 	pImage->pSurface = pSurface;
+	pImage->bExternalTexture = FALSE;
 	pImage->iWidth = iWidth;
 	pImage->iHeight = iHeight;
 	pImage->fZoomX = 1.;
 	pImage->fZoomY = 1.;
 	if (g_bUseOpenGL)
+	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+		cairo_dock_image_buffer_texture_modified (pImage);
+	}
 }
 
 void cairo_dock_load_image_buffer_from_texture (CairoDockImageBuffer *pImage, GLuint iTexture, int iWidth, int iHeight)
 {
 	pImage->iTexture = iTexture;
+	pImage->bExternalTexture = TRUE;  // we don't know when its content changes.
 	pImage->iWidth = iWidth;
 	pImage->iHeight = iHeight;
 	pImage->fZoomX = 1.;
 	pImage->fZoomY = 1.;
+	cairo_dock_image_buffer_texture_modified (pImage);
 }
 
 CairoDockImageBuffer *cairo_dock_create_image_buffer (const gchar *cImageFile, int iWidth, int iHeight, CairoDockLoadImageModifier iLoadModifier)
@@ -637,6 +647,7 @@ void cairo_dock_end_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, Gldi
 			0);  // we detach the texture (precaution).
 		//glGenerateMipmapEXT(GL_TEXTURE_2D);  // if we use mipmaps, we need to explicitely generate them when using FBO.
 	}
+	cairo_dock_image_buffer_texture_modified (pImage);
 	
 	if (pContainer && s_bSetPerspective)
 	{
@@ -688,6 +699,13 @@ void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage)
 				cairo_image_surface_get_data (pImage->pSurface));
 		_cairo_dock_disable_texture ();
 	}
+	cairo_dock_image_buffer_texture_modified (pImage);
+}
+
+void cairo_dock_image_buffer_texture_modified (CairoDockImageBuffer *pImage)
+{
+	static guint s_iRevision = 0;  // a global counter, so that a texture ID re-used by another image gets another revision too
+	pImage->iRevision = ++ s_iRevision;
 }
 
 
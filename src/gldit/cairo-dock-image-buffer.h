@@ -52,6 +52,8 @@ struct _CairoDockImageBuffer {
 	gdouble iCurrentFrame; // current frame, the decimal part indicates we are between 2 frames.
 	gdouble fDeltaFrame;  // duration of 1 frame
 	struct timeval time;  // time the current frame has been set
+	guint iRevision;  // changes each time the texture is created or modified, see cairo_dock_image_buffer_texture_modified()
+	gboolean bExternalTexture;  // the texture belongs to someone else (ex.: the texture of a window), and can change without the buffer knowing it.
 	} ;
 
 /** Find the path of an image. '~' is handled, as well as the 'images' folder of the current theme. Use \ref cairo_dock_search_icon_s_path to search theme icons.
@@ -193,6 +195,11 @@ void cairo_dock_end_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, Gldi
 
 void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage);
 
+/** Tell that the texture of an image buffer has been modified, so that the copies of it (like the one in the icons atlas) are updated. The functions of this file do it for you; you only need to call it if you modify the texture directly.
+*@param pImage the image buffer.
+*/
+void cairo_dock_image_buffer_texture_modified (CairoDockImageBuffer *pImage);
+
 
 GdkPixbuf *cairo_dock_image_buffer_to_pixbuf (CairoDockImageBuffer *pImage, int iWidth, int iHeight);
 
@@ -0,0 +1,447 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>  // close, write
+#include <fcntl.h>  // open
+#include <sys/stat.h>  // fstat
+#include <sys/mman.h>  // mmap
+
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-image-cache.h"
+
+extern gboolean g_bUseOpenGL;
+
+#define CD_IMAGE_CACHE_MAGIC 0x43444943  // "CDIC"
+#define CD_IMAGE_CACHE_VERSION 1
+#define CD_IMAGE_CACHE_DATA_OFFSET 128  // the pixels start on a 128 bytes boundary, so that the mapped buffer is well aligned.
+#define CD_IMAGE_CACHE_SUFFIX ".argb"
+#define CD_IMAGE_CACHE_TMP_PREFIX ".tmp-"
+#define CD_IMAGE_CACHE_TOUCH_DELAY ((gint64)24 * 3600 * G_USEC_PER_SEC)  // the last use of an entry is written on the disk at most once a day.
+
+// header of a cache file; it's followed by the premultiplied ARGB32 pixels, as cairo stores them.
+typedef struct {
+	guint32 iMagic;
+	guint32 iVersion;
+	gint32 iPixelWidth;
+	gint32 iPixelHeight;
+	gint32 iStride;
+	gint32 iReserved;
+	gdouble fImageWidth;
+	gdouble fImageHeight;
+	gdouble fZoomX;
+	gdouble fZoomY;
+	gdouble fDeviceScaleX;
+	gdouble fDeviceScaleY;
+} CDImageCacheHeader;
+G_STATIC_ASSERT (sizeof (CDImageCacheHeader) <= CD_IMAGE_CACHE_DATA_OFFSET);
+
+typedef struct {
+	gsize iSize;
+	gint64 iLastUse;
+} CDImageCacheEntry;
+
+typedef struct {
+	gpointer pData;
+	gsize iSize;
+} CDImageCacheMapping;
+
+static GMutex s_mutex;  // the cache can be used by the threads that load images in background.
+static gchar *s_cCacheDir = NULL;
+static GHashTable *s_pEntries = NULL;  // file name -> CDImageCacheEntry
+static gsize s_iMaxSize = CAIRO_DOCK_IMAGE_CACHE_DEFAULT_MAX_SIZE;
+static CairoDockImageCacheStats s_stats;
+static const cairo_user_data_key_t s_mappingKey;
+
+
+// the name of an entry is a hash of everything that can change the resulting surface.
+static gchar *_get_entry_name (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale)
+{
+	struct stat st;
+	if (g_stat (cImagePath, &st) != 0)
+		return NULL;
+	gchar *cKey = g_strdup_printf ("%s:%ld:%lld:%dx%d:%d:%.4f:%.2f",
+		cImagePath,
+		(long)st.st_mtime,
+		(long long)st.st_size,
+		iWidthConstraint, iHeightConstraint,
+		iLoadingModifier,
+		fMaxScale,
+		fDeviceScale);
+	gchar *cHash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, cKey, -1);
+	gchar *cName = g_strconcat (cHash, CD_IMAGE_CACHE_SUFFIX, NULL);
+	g_free (cHash);
+	g_free (cKey);
+	return cName;
+}
+
+static void _unmap_data (CDImageCacheMapping *pMapping)
+{
+	munmap (pMapping->pData, pMapping->iSize);
+	g_free (pMapping);
+}
+
+static gint _compare_entries_by_use (gconstpointer a, gconstpointer b, gpointer data)
+{
+	GHashTable *pEntries = data;
+	CDImageCacheEntry *e1 = g_hash_table_lookup (pEntries, a);
+	CDImageCacheEntry *e2 = g_hash_table_lookup (pEntries, b);
+	return (e1->iLastUse < e2->iLastUse ? -1 : e1->iLastUse > e2->iLastUse ? 1 : 0);
+}
+
+static void _remove_entry_locked (const gchar *cName)
+{
+	CDImageCacheEntry *pEntry = g_hash_table_lookup (s_pEntries, cName);
+	if (pEntry == NULL)
+		return;
+	gchar *cFile = g_build_filename (s_cCacheDir, cName, NULL);
+	g_remove (cFile);
+	g_free (cFile);
+	s_stats.iTotalSize -= MIN (s_stats.iTotalSize, pEntry->iSize);
+	g_hash_table_remove (s_pEntries, cName);
+}
+
+// remove the least recently used entries until the cache fits in 90% of its maximum size, to not evict at each new entry.
+static void _evict_entries_locked (void)
+{
+	if (s_stats.iTotalSize <= s_iMaxSize)
+		return;
+	GList *pNames = g_hash_table_get_keys (s_pEntries);
+	pNames = g_list_sort_with_data (pNames, _compare_entries_by_use, s_pEntries);
+	gsize iTargetSize = s_iMaxSize / 10 * 9;
+	GList *n;
+	for (n = pNames; n != NULL && s_stats.iTotalSize > iTargetSize; n = n->next)
+	{
+		gchar *cName = g_strdup (n->data);  // the key is freed with the entry
+		_remove_entry_locked (cName);
+		g_free (cName);
+		s_stats.iNbEvictions ++;
+	}
+	g_list_free (pNames);
+	cd_debug ("image cache: %u entries, %lu bytes", g_hash_table_size (s_pEntries), (gulong)s_stats.iTotalSize);
+}
+
+
+void cairo_dock_image_cache_init (void)
+{
+	g_mutex_lock (&s_mutex);
+	if (s_pEntries != NULL)  // already done
+	{
+		g_mutex_unlock (&s_mutex);
+		return;
+	}
+	s_pEntries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	s_cCacheDir = g_build_filename (g_get_user_cache_dir (), "cairo-dock", "images", NULL);
+	if (g_mkdir_with_parents (s_cCacheDir, 0700) != 0)
+	{
+		cd_warning ("couldn't create the folder '%s', images will not be cached", s_cCacheDir);
+		s_iMaxSize = 0;
+	}
+
+	// index the existing entries; the modification time of a file is the last time it was used.
+	GDir *dir = g_dir_open (s_cCacheDir, 0, NULL);
+	if (dir != NULL)
+	{
+		const gchar *cName;
+		struct stat st;
+		while ((cName = g_dir_read_name (dir)) != NULL)
+		{
+			gchar *cFile = g_build_filename (s_cCacheDir, cName, NULL);
+			if (g_str_has_prefix (cName, CD_IMAGE_CACHE_TMP_PREFIX))  // left by a crash during a write
+			{
+				g_remove (cFile);
+			}
+			else if (g_str_has_suffix (cName, CD_IMAGE_CACHE_SUFFIX) && g_stat (cFile, &st) == 0)
+			{
+				CDImageCacheEntry *pEntry = g_new (CDImageCacheEntry, 1);
+				pEntry->iSize = st.st_size;
+				pEntry->iLastUse = (gint64)st.st_mtime * G_USEC_PER_SEC;
+				g_hash_table_insert (s_pEntries, g_strdup (cName), pEntry);
+				s_stats.iTotalSize += pEntry->iSize;
+			}
+			g_free (cFile);
+		}
+		g_dir_close (dir);
+	}
+	_evict_entries_locked ();
+	g_mutex_unlock (&s_mutex);
+}
+
+
+cairo_surface_t *cairo_dock_image_cache_lookup (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	if (s_pEntries == NULL || s_iMaxSize == 0 || cImagePath == NULL)
+		return NULL;
+	gchar *cName = _get_entry_name (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fDeviceScale);
+	if (cName == NULL)  // the image doesn't exist, let the loader complain about it.
+		return NULL;
+
+	g_mutex_lock (&s_mutex);
+	CDImageCacheEntry *pEntry = g_hash_table_lookup (s_pEntries, cName);
+	if (pEntry == NULL)
+	{
+		s_stats.iNbMisses ++;
+		g_mutex_unlock (&s_mutex);
+		g_free (cName);
+		return NULL;
+	}
+	g_mutex_unlock (&s_mutex);
+
+	//\_______________ map the file in memory.
+	cairo_surface_t *pSurface = NULL;
+	gchar *cFile = g_build_filename (s_cCacheDir, cName, NULL);
+	CDImageCacheMapping *pMapping = NULL;
+	int fd = g_open (cFile, O_RDONLY, 0);
+	if (fd >= 0)
+	{
+		struct stat st;
+		if (fstat (fd, &st) == 0 && st.st_size > CD_IMAGE_CACHE_DATA_OFFSET)
+		{
+			gpointer pData = mmap (NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);  // private and writable, since some callers draw on the surfaces they get.
+			if (pData != MAP_FAILED)
+			{
+				pMapping = g_new (CDImageCacheMapping, 1);
+				pMapping->pData = pData;
+				pMapping->iSize = st.st_size;
+			}
+		}
+		close (fd);
+	}
+
+	//\_______________ check the header and create a surface on top of the pixels.
+	if (pMapping != NULL)
+	{
+		CDImageCacheHeader *pHeader = pMapping->pData;
+		if (pHeader->iMagic == CD_IMAGE_CACHE_MAGIC
+		&& pHeader->iVersion == CD_IMAGE_CACHE_VERSION
+		&& pHeader->iPixelWidth > 0 && pHeader->iPixelHeight > 0
+		&& pHeader->iStride >= cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, pHeader->iPixelWidth)
+		&& (gsize)CD_IMAGE_CACHE_DATA_OFFSET + (gsize)pHeader->iStride * pHeader->iPixelHeight == pMapping->iSize)
+		{
+			pSurface = cairo_image_surface_create_for_data ((guchar *)pMapping->pData + CD_IMAGE_CACHE_DATA_OFFSET,
+				CAIRO_FORMAT_ARGB32,
+				pHeader->iPixelWidth,
+				pHeader->iPixelHeight,
+				pHeader->iStride);
+			cairo_surface_set_device_scale (pSurface, pHeader->fDeviceScaleX, pHeader->fDeviceScaleY);
+			cairo_surface_set_user_data (pSurface, &s_mappingKey, pMapping, (cairo_destroy_func_t) _unmap_data);
+			*fImageWidth = pHeader->fImageWidth;
+			*fImageHeight = pHeader->fImageHeight;
+			if (fZoomX != NULL)
+				*fZoomX = pHeader->fZoomX;
+			if (fZoomY != NULL)
+				*fZoomY = pHeader->fZoomY;
+		}
+		else
+		{
+			_unmap_data (pMapping);
+		}
+	}
+
+	if (pSurface != NULL && ! g_bUseOpenGL)  // in cairo mode, surfaces are similar to the screen, for a faster drawing; so copy the pixels into such a surface.
+	{
+		cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
+			ceil ((*fImageWidth) * fMaxScale),
+			ceil ((*fImageHeight) * fMaxScale));
+		cairo_t *pCairoContext = cairo_create (pNewSurface);
+		cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+		cairo_set_source_surface (pCairoContext, pSurface, 0, 0);
+		cairo_paint (pCairoContext);
+		cairo_destroy (pCairoContext);
+		cairo_surface_destroy (pSurface);  // unmaps the file
+		pSurface = pNewSurface;
+	}
+
+	gboolean bTouchFile = FALSE;
+	g_mutex_lock (&s_mutex);
+	if (pSurface != NULL)
+	{
+		s_stats.iNbHits ++;
+		pEntry = g_hash_table_lookup (s_pEntries, cName);  // it may have been evicted in the meantime
+		if (pEntry != NULL)
+		{
+			gint64 iNow = g_get_real_time ();
+			bTouchFile = (iNow - pEntry->iLastUse > CD_IMAGE_CACHE_TOUCH_DELAY);
+			pEntry->iLastUse = iNow;
+		}
+	}
+	else  // invalid or vanished file
+	{
+		s_stats.iNbMisses ++;
+		_remove_entry_locked (cName);
+	}
+	g_mutex_unlock (&s_mutex);
+
+	if (bTouchFile)
+		g_utime (cFile, NULL);  // remember the last use for the next session; a precision of a day is enough to evict the oldest entries.
+
+	g_free (cFile);
+	g_free (cName);
+	return pSurface;
+}
+
+
+static gboolean _write_all (int fd, const guchar *pData, gsize iSize)
+{
+	gssize n;
+	while (iSize > 0)
+	{
+		n = write (fd, pData, iSize);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		pData += n;
+		iSize -= n;
+	}
+	return TRUE;
+}
+
+void cairo_dock_image_cache_store (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY)
+{
+	if (s_pEntries == NULL || s_iMaxSize == 0 || pSurface == NULL || cImagePath == NULL)
+		return;
+	if (cairo_surface_status (pSurface) != CAIRO_STATUS_SUCCESS)
+		return;
+	gchar *cName = _get_entry_name (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fDeviceScale);
+	if (cName == NULL)
+		return;
+
+	//\_______________ get the pixels of the surface (it may be an X surface in cairo mode).
+	cairo_surface_flush (pSurface);
+	cairo_surface_t *pImageSurface = cairo_surface_map_to_image (pSurface, NULL);
+	if (cairo_surface_status (pImageSurface) != CAIRO_STATUS_SUCCESS
+	|| cairo_image_surface_get_format (pImageSurface) != CAIRO_FORMAT_ARGB32)
+	{
+		cairo_surface_unmap_image (pSurface, pImageSurface);
+		g_free (cName);
+		return;
+	}
+	CDImageCacheHeader header;
+	memset (&header, 0, sizeof (header));
+	header.iMagic = CD_IMAGE_CACHE_MAGIC;
+	header.iVersion = CD_IMAGE_CACHE_VERSION;
+	header.iPixelWidth = cairo_image_surface_get_width (pImageSurface);
+	header.iPixelHeight = cairo_image_surface_get_height (pImageSurface);
+	header.iStride = cairo_image_surface_get_stride (pImageSurface);
+	header.fImageWidth = fImageWidth;
+	header.fImageHeight = fImageHeight;
+	header.fZoomX = fZoomX;
+	header.fZoomY = fZoomY;
+	header.fDeviceScaleX = header.fDeviceScaleY = 1.;
+	cairo_surface_get_device_scale (pSurface, &header.fDeviceScaleX, &header.fDeviceScaleY);
+	gsize iDataSize = (gsize)header.iStride * header.iPixelHeight;
+
+	//\_______________ write it in a temporary file and move it into place, so that a reader never sees a partial entry.
+	gchar *cTmpFile = g_strdup_printf ("%s/"CD_IMAGE_CACHE_TMP_PREFIX"XXXXXX", s_cCacheDir);
+	gboolean bSuccess = FALSE;
+	int fd = g_mkstemp (cTmpFile);
+	if (fd >= 0)
+	{
+		guchar padding[CD_IMAGE_CACHE_DATA_OFFSET];
+		memset (padding, 0, sizeof (padding));
+		memcpy (padding, &header, sizeof (header));
+		bSuccess = (_write_all (fd, padding, sizeof (padding))
+			&& _write_all (fd, cairo_image_surface_get_data (pImageSurface), iDataSize));
+		bSuccess = (close (fd) == 0) && bSuccess;
+
+		if (bSuccess)
+		{
+			gchar *cFile = g_build_filename (s_cCacheDir, cName, NULL);
+			bSuccess = (g_rename (cTmpFile, cFile) == 0);
+			g_free (cFile);
+		}
+		if (! bSuccess)
+			g_remove (cTmpFile);
+	}
+	g_free (cTmpFile);
+	cairo_surface_unmap_image (pSurface, pImageSurface);
+
+	//\_______________ index the new entry.
+	if (bSuccess)
+	{
+		g_mutex_lock (&s_mutex);
+		_remove_entry_locked (cName);  // in case it was already there (2 threads loaded the same image)
+		CDImageCacheEntry *pEntry = g_new (CDImageCacheEntry, 1);
+		pEntry->iSize = CD_IMAGE_CACHE_DATA_OFFSET + iDataSize;
+		pEntry->iLastUse = g_get_real_time ();
+		g_hash_table_insert (s_pEntries, cName, pEntry);
+		cName = NULL;  // owned by the table now
+		s_stats.iTotalSize += pEntry->iSize;
+		s_stats.iNbStores ++;
+		_evict_entries_locked ();
+		g_mutex_unlock (&s_mutex);
+	}
+	g_free (cName);
+}
+
+
+static gboolean _remove_file (gpointer key, G_GNUC_UNUSED gpointer value, G_GNUC_UNUSED gpointer data)
+{
+	gchar *cFile = g_build_filename (s_cCacheDir, (gchar*)key, NULL);
+	g_remove (cFile);
+	g_free (cFile);
+	return TRUE;
+}
+void cairo_dock_image_cache_clear (void)
+{
+	g_mutex_lock (&s_mutex);
+	if (s_pEntries != NULL)
+	{
+		cd_message ("image cache: %u hits, %u misses, %u stores; removing %u entries",
+			s_stats.iNbHits, s_stats.iNbMisses, s_stats.iNbStores, g_hash_table_size (s_pEntries));
+		g_hash_table_foreach_remove (s_pEntries, (GHRFunc) _remove_file, NULL);
+		s_stats.iTotalSize = 0;
+	}
+	g_mutex_unlock (&s_mutex);
+}
+
+
+void cairo_dock_image_cache_set_max_size (gsize iMaxSize)
+{
+	g_mutex_lock (&s_mutex);
+	s_iMaxSize = iMaxSize;
+	if (s_pEntries != NULL)
+	{
+		if (iMaxSize == 0)
+		{
+			g_hash_table_foreach_remove (s_pEntries, (GHRFunc) _remove_file, NULL);
+			s_stats.iTotalSize = 0;
+		}
+		else
+			_evict_entries_locked ();
+	}
+	g_mutex_unlock (&s_mutex);
+}
+
+
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats)
+{
+	g_mutex_lock (&s_mutex);
+	*pStats = s_stats;
+	pStats->iNbEntries = (s_pEntries != NULL ? g_hash_table_size (s_pEntries) : 0);
+	g_mutex_unlock (&s_mutex);
+}
@@ -0,0 +1,91 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_IMAGE_CACHE__
+#define  __CAIRO_DOCK_IMAGE_CACHE__
+
+#include <glib.h>
+#include <cairo.h>
+
+#include "cairo-dock-struct.h"
+#include "cairo-dock-surface-factory.h"  // CairoDockLoadImageModifier
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-image-cache.h This class implements a persistent cache of rasterized images.
+* Each time an image file is loaded at a given size, the resulting premultiplied ARGB32 buffer is stored in the user's cache folder (~/.cache/cairo-dock/images), so that the next time the same image is requested with the same parameters, it can be mapped in memory instead of being decoded again.
+*
+* An entry is identified by the path of the image, its modification time and size, the requested size, the loading modifier and the scale factor; so a modified file is never taken from the cache.
+* The cache is bounded in size, the least recently used entries being removed first. It is emptied when the icon theme changes.
+*
+* You don't need to use this directly, \ref cairo_dock_create_surface_from_image does it for you.
+*/
+
+/// Default maximum size of the cache on the disk, in bytes.
+#define CAIRO_DOCK_IMAGE_CACHE_DEFAULT_MAX_SIZE (64 * 1024 * 1024)
+
+/// Statistics of the image cache, to check its efficiency.
+typedef struct _CairoDockImageCacheStats {
+	/// number of images found in the cache
+	guint iNbHits;
+	/// number of images not found in the cache
+	guint iNbMisses;
+	/// number of images written into the cache
+	guint iNbStores;
+	/// number of entries removed to keep the cache under its maximum size
+	guint iNbEvictions;
+	/// current size of the cache, in bytes
+	gsize iTotalSize;
+	/// current number of entries in the cache
+	guint iNbEntries;
+	} CairoDockImageCacheStats;
+
+/** Initialize the image cache: create its folder if needed and index the existing entries. It's safe to call it several times.
+*/
+void cairo_dock_image_cache_init (void);
+
+/** Look for an image in the cache. The parameters are the same as for \ref cairo_dock_create_surface_from_image. It can be called from any thread.
+*@param fDeviceScale device scale of the surface that would be created from the image (the scale of the screen, or the one forced by a background load).
+*@return a newly allocated surface, or NULL if the image is not in the cache (or the cache is disabled).
+*/
+cairo_surface_t *cairo_dock_image_cache_lookup (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
+
+/** Store a freshly loaded image into the cache. The parameters are the same as the ones given to, and returned by, \ref cairo_dock_create_surface_from_image. It can be called from any thread.
+*@param fDeviceScale the same device scale as for \ref cairo_dock_image_cache_lookup.
+*@param pSurface the surface that has been created from the image.
+*/
+void cairo_dock_image_cache_store (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY);
+
+/** Remove all the entries of the cache. This is done automatically when the icon theme changes.
+*/
+void cairo_dock_image_cache_clear (void);
+
+/** Set the maximum size of the cache on the disk. Entries are removed if the cache is already bigger.
+*@param iMaxSize maximum size in bytes, or 0 to disable the cache.
+*/
+void cairo_dock_image_cache_set_max_size (gsize iMaxSize);
+
+/** Get the statistics of the cache since it has been initialized.
+*@param pStats will be filled with the current statistics.
+*/
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats);
+
+G_END_DECLS
+#endif
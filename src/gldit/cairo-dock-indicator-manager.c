@@ -57,9 +57,6 @@ static CairoDockImageBuffer s_indicatorBuffer;
 static CairoDockImageBuffer s_activeIndicatorBuffer;
 static CairoDockImageBuffer s_classIndicatorBuffer;
 
-static gboolean cairo_dock_pre_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, cairo_t *pCairoContext);
-static gboolean cairo_dock_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, gboolean *bHasBeenRendered, cairo_t *pCairoContext);
-
 
   /////////////////
  /// RENDERING ///
@@ -267,7 +264,7 @@ static inline gboolean _active_indicator_is_visible (Icon *icon)
 	return bIsActive;
 }
 
-static gboolean cairo_dock_pre_render_indicator_notification (G_GNUC_UNUSED gpointer pUserData, Icon *icon, CairoDock *pDock, cairo_t *pCairoContext)
+gboolean cairo_dock_pre_render_indicator_notification (G_GNUC_UNUSED gpointer pUserData, Icon *icon, CairoDock *pDock, cairo_t *pCairoContext)
 {
 	gboolean bIsActive = (myIndicatorsParam.bActiveIndicatorAbove ? FALSE : _active_indicator_is_visible (icon));
 	
@@ -298,7 +295,7 @@ static gboolean cairo_dock_pre_render_indicator_notification (G_GNUC_UNUSED gpoi
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
-static gboolean cairo_dock_render_indicator_notification (G_GNUC_UNUSED gpointer pUserData, Icon *icon, CairoDock *pDock, G_GNUC_UNUSED gboolean *bHasBeenRendered, cairo_t *pCairoContext)
+gboolean cairo_dock_render_indicator_notification (G_GNUC_UNUSED gpointer pUserData, Icon *icon, CairoDock *pDock, G_GNUC_UNUSED gboolean *bHasBeenRendered, cairo_t *pCairoContext)
 {
 	gboolean bIsActive = (myIndicatorsParam.bActiveIndicatorAbove ? _active_indicator_is_visible (icon) : FALSE);
 	
@@ -75,6 +75,10 @@ typedef enum {
 	} CairoIndicatorsNotifications;
 
 
+// the notifications that draw the indicators of an icon, below and above it.
+gboolean cairo_dock_pre_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, cairo_t *pCairoContext);
+gboolean cairo_dock_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, gboolean *bHasBeenRendered, cairo_t *pCairoContext);
+
 void gldi_register_indicators_manager (void);
 
 G_END_DECLS
@@ -23,9 +23,74 @@
 #include "cairo-dock-log.h"
 #include "cairo-dock-keyfile-utilities.h"
 
+#define CAIRO_DOCK_KEYFILE_FLUSH_DELAY 500  // ms of calm before the pending changes are written
+
+// key-files modified by cairo_dock_update_keyfile() and not yet written on the disk (path -> key-file).
+static GHashTable *s_hPendingKeyFiles = NULL;
+static GMutex s_mutex;  // key-files can be opened by threads
+static guint s_iSidFlush = 0;
+
+static void _write_keys_to_file (GKeyFile *pKeyFile, const gchar *cConfFilePath, gboolean bAllowEmpty);
+
+static gboolean _flush_pending_key_files (G_GNUC_UNUSED gpointer data)
+{
+	g_mutex_lock (&s_mutex);
+	s_iSidFlush = 0;
+	g_mutex_unlock (&s_mutex);
+	cairo_dock_sync_all_keyfiles ();
+	return FALSE;
+}
+
+void cairo_dock_sync_keyfile (const gchar *cConfFilePath)
+{
+	g_mutex_lock (&s_mutex);
+	if (s_hPendingKeyFiles != NULL)
+	{
+		GKeyFile *pKeyFile = g_hash_table_lookup (s_hPendingKeyFiles, cConfFilePath);
+		if (pKeyFile != NULL)
+		{
+			_write_keys_to_file (pKeyFile, cConfFilePath, FALSE);
+			g_hash_table_remove (s_hPendingKeyFiles, cConfFilePath);
+		}
+	}
+	g_mutex_unlock (&s_mutex);
+}
+
+void cairo_dock_sync_all_keyfiles (void)
+{
+	g_mutex_lock (&s_mutex);
+	if (s_iSidFlush != 0)
+	{
+		g_source_remove (s_iSidFlush);
+		s_iSidFlush = 0;
+	}
+	if (s_hPendingKeyFiles != NULL)
+	{
+		GHashTableIter iter;
+		gpointer cConfFilePath, pKeyFile;
+		g_hash_table_iter_init (&iter, s_hPendingKeyFiles);
+		while (g_hash_table_iter_next (&iter, &cConfFilePath, &pKeyFile))
+		{
+			_write_keys_to_file (pKeyFile, cConfFilePath, FALSE);
+			g_hash_table_iter_remove (&iter);
+		}
+	}
+	g_mutex_unlock (&s_mutex);
+}
+
+static void _forget_pending_key_file (const gchar *cConfFilePath)
+{
+	g_mutex_lock (&s_mutex);
+	if (s_hPendingKeyFiles != NULL)
+		g_hash_table_remove (s_hPendingKeyFiles, cConfFilePath);
+	g_mutex_unlock (&s_mutex);
+}
+
 
 GKeyFile *cairo_dock_open_key_file (const gchar *cConfFilePath)
 {
+	cairo_dock_sync_keyfile (cConfFilePath);  // so that we read the latest values.
+	
 	GKeyFile *pKeyFile = g_key_file_new ();
 	GError *erreur = NULL;
 	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &erreur);
@@ -40,6 +105,12 @@ GKeyFile *cairo_dock_open_key_file (const gchar *cConfFilePath)
 }
 
 void cairo_dock_write_keys_to_file_full (GKeyFile *pKeyFile, const gchar *cConfFilePath, gboolean bAllowEmpty)
+{
+	_forget_pending_key_file (cConfFilePath);  // the whole file is replaced, the pending changes don't matter any more.
+	_write_keys_to_file (pKeyFile, cConfFilePath, bAllowEmpty);
+}
+
+static void _write_keys_to_file (GKeyFile *pKeyFile, const gchar *cConfFilePath, gboolean bAllowEmpty)
 {
 	cd_debug ("%s (%s)", __func__, cConfFilePath);
 	GError *erreur = NULL;
@@ -403,8 +474,16 @@ void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirst
 {
 	cd_message ("%s (%s)", __func__, cConfFilePath);
 	
-	GKeyFile *pKeyFile = g_key_file_new ();  // if the key-file doesn't exist, it will be created.
-	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, NULL);
+	g_mutex_lock (&s_mutex);
+	if (s_hPendingKeyFiles == NULL)
+		s_hPendingKeyFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_key_file_free);
+	GKeyFile *pKeyFile = g_hash_table_lookup (s_hPendingKeyFiles, cConfFilePath);  // if the file has already been modified recently, just add the changes.
+	if (pKeyFile == NULL)
+	{
+		pKeyFile = g_key_file_new ();  // if the key-file doesn't exist, it will be created.
+		g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, NULL);
+		g_hash_table_insert (s_hPendingKeyFiles, g_strdup (cConfFilePath), pKeyFile);
+	}
 	
 	GType iType = iFirstDataType;
 	gboolean bValue;
@@ -441,9 +520,12 @@ void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirst
 
 		iType = va_arg (args, GType);
 	}
-
-	cairo_dock_write_keys_to_file (pKeyFile, cConfFilePath);
-	g_key_file_free (pKeyFile);
+	
+	// write the changes once they stop coming (e.g. when the icons of a dock are re-ordered, or a desklet is resized).
+	if (s_iSidFlush != 0)
+		g_source_remove (s_iSidFlush);
+	s_iSidFlush = g_timeout_add (CAIRO_DOCK_KEYFILE_FLUSH_DELAY, _flush_pending_key_files, NULL);
+	g_mutex_unlock (&s_mutex);
 }
 
 void cairo_dock_update_keyfile (const gchar *cConfFilePath, GType iFirstDataType, ...)  // type, groupe, cle, valeur, etc. finir par G_TYPE_INVALID.
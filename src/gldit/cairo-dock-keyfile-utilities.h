@@ -89,10 +89,20 @@ gchar * cairo_dock_get_locale_string_from_conf_file (GKeyFile *pKeyFile, const g
 void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirstDataType, va_list args);
 
 /** Update a conf file with a list of values of the form : {type, name of the groupe, name of the key, value}. Must end with G_TYPE_INVALID.
+* The changes are kept in memory and written on the disk (atomically) once no more changes come for a short time, so that a burst of updates costs only one write. Opening the file with \ref cairo_dock_open_key_file gives the latest values.
 *@param cConfFilePath path to the conf file.
 *@param iFirstDataType type of the first value.
 */
 void cairo_dock_update_keyfile (const gchar *cConfFilePath, GType iFirstDataType, ...);
 
+/** Write on the disk the pending changes made on a conf file with \ref cairo_dock_update_keyfile. Call it before reading or copying the file by another mean than \ref cairo_dock_open_key_file.
+*@param cConfFilePath path to the conf file.
+*/
+void cairo_dock_sync_keyfile (const gchar *cConfFilePath);
+
+/** Write on the disk all the pending changes made with \ref cairo_dock_update_keyfile. It is done when the dock quits.
+*/
+void cairo_dock_sync_all_keyfiles (void);
+
 G_END_DECLS
 #endif
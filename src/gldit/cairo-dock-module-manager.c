@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include <glib/gstdio.h>
 #include <dlfcn.h>
 
@@ -33,6 +34,7 @@
 #include "cairo-dock-desklet-manager.h"
 #include "cairo-dock-animations.h"
 #include "cairo-dock-config.h"
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_write_keys_to_file
 #include "cairo-dock-module-instance-manager.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-module-manager.h"
@@ -56,6 +58,11 @@ extern gboolean g_bEasterEggs;
 static GHashTable *s_hModuleTable = NULL;
 static GList *s_AutoLoadedModules = NULL;
 static guint s_iSidWriteModules = 0;
+static GKeyFile *s_pModuleIndex = NULL;  // visit cards of the modules, to register them without opening their library.
+static gchar *s_cModuleIndexPath = NULL;
+static gboolean s_bModuleIndexChanged = FALSE;
+
+#define CD_MODULE_INDEX_GROUP "Index"
 
 
   ///////////////
@@ -146,9 +153,28 @@ GldiModule *gldi_module_new (GldiVisitCard *pVisitCard, GldiModuleInterface *pIn
 	return (GldiModule*)gldi_object_new (&myModuleObjectMgr, &attr);
 }
 
-GldiModule *gldi_module_new_from_so_file (const gchar *cSoFilePath)
+static gboolean _module_is_compatible (const gchar *cSoFilePath, GldiVisitCard *pVisitCard)
+{
+	if (! g_bEasterEggs &&
+		(pVisitCard->iMajorVersionNeeded > g_iMajorVersion
+		|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded > g_iMinorVersion)
+		|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded == g_iMinorVersion && pVisitCard->iMicroVersionNeeded > g_iMicroVersion)))
+	{
+		cd_warning ("this module ('%s') needs at least Cairo-Dock v%d.%d.%d, but Cairo-Dock is in v%d.%d.%d (%s)\n  It will be ignored", cSoFilePath, pVisitCard->iMajorVersionNeeded, pVisitCard->iMinorVersionNeeded, pVisitCard->iMicroVersionNeeded, g_iMajorVersion, g_iMinorVersion, g_iMicroVersion, GLDI_VERSION);
+		return FALSE;
+	}
+	if (! g_bEasterEggs
+	&& pVisitCard->cDockVersionOnCompilation != NULL && strcmp (pVisitCard->cDockVersionOnCompilation, GLDI_VERSION) != 0)  // separation des versions en easter egg.
+	{
+		cd_warning ("this module ('%s') was compiled with Cairo-Dock v%s, but Cairo-Dock is in v%s\n  It will be ignored", cSoFilePath, pVisitCard->cDockVersionOnCompilation, GLDI_VERSION);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+// open the .so file and run its pre-init entry point; returns the handle on the library, or NULL if the module can't be used.
+static gpointer _open_module_library (const gchar *cSoFilePath, GldiVisitCard **pVisitCardPtr, GldiModuleInterface **pInterfacePtr)
 {
-	g_return_val_if_fail (cSoFilePath != NULL, NULL);
 	GldiVisitCard *pVisitCard = NULL;
 	GldiModuleInterface *pInterface = NULL;
 	
@@ -183,33 +209,257 @@ GldiModule *gldi_module_new_from_so_file (const gchar *cSoFilePath)
 	}
 	
 	// check module compatibility
-	if (! g_bEasterEggs &&
-		(pVisitCard->iMajorVersionNeeded > g_iMajorVersion
-		|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded > g_iMinorVersion)
-		|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded == g_iMinorVersion && pVisitCard->iMicroVersionNeeded > g_iMicroVersion)))
-	{
-		cd_warning ("this module ('%s') needs at least Cairo-Dock v%d.%d.%d, but Cairo-Dock is in v%d.%d.%d (%s)\n  It will be ignored", cSoFilePath, pVisitCard->iMajorVersionNeeded, pVisitCard->iMinorVersionNeeded, pVisitCard->iMicroVersionNeeded, g_iMajorVersion, g_iMinorVersion, g_iMicroVersion, GLDI_VERSION);
+	if (! _module_is_compatible (cSoFilePath, pVisitCard))
 		goto discard;
+	
+	*pVisitCardPtr = pVisitCard;
+	*pInterfacePtr = pInterface;
+	return handle;
+	
+discard:
+	///g_module_close (pModule);
+	dlclose (handle);
+	cairo_dock_free_visit_card (pVisitCard);
+	g_free (pInterface);
+	return NULL;
+}
+
+  ////////////////////
+ /// MODULE INDEX ///
+////////////////////
+
+// Until a module is activated, its interface only holds these functions; they are replaced by the actual ones when its library is loaded.
+static void _init_module_from_index (GldiModuleInstance *pInstance, GKeyFile *pKeyFile)
+{
+	if (gldi_module_load (pInstance->pModule))
+		pInstance->pModule->pInterface->initModule (pInstance, pKeyFile);
+}
+static void _stop_module_from_index (G_GNUC_UNUSED GldiModuleInstance *pInstance)
+{
+	// the module could not be loaded, so it has not been started.
+}
+
+static void _load_module_index (void)
+{
+	s_cModuleIndexPath = g_build_filename (g_get_user_cache_dir (), "cairo-dock", "modules.index", NULL);
+	s_pModuleIndex = g_key_file_new ();
+	if (g_key_file_load_from_file (s_pModuleIndex, s_cModuleIndexPath, G_KEY_FILE_NONE, NULL))
+	{
+		// the visit cards depend on the version of the dock and on the language (the title is translated).
+		gchar *cVersion = g_key_file_get_string (s_pModuleIndex, CD_MODULE_INDEX_GROUP, "version", NULL);
+		gchar *cLanguage = g_key_file_get_string (s_pModuleIndex, CD_MODULE_INDEX_GROUP, "language", NULL);
+		gboolean bValid = (g_strcmp0 (cVersion, GLDI_VERSION) == 0 && g_strcmp0 (cLanguage, g_get_language_names ()[0]) == 0);
+		g_free (cVersion);
+		g_free (cLanguage);
+		if (bValid)
+			return;
+		cd_message ("the index of the modules is out of date, it will be rebuilt");
+		g_key_file_free (s_pModuleIndex);
+		s_pModuleIndex = g_key_file_new ();
 	}
-	if (! g_bEasterEggs
-	&& pVisitCard->cDockVersionOnCompilation != NULL && strcmp (pVisitCard->cDockVersionOnCompilation, GLDI_VERSION) != 0)  // separation des versions en easter egg.
+	g_key_file_set_string (s_pModuleIndex, CD_MODULE_INDEX_GROUP, "version", GLDI_VERSION);
+	g_key_file_set_string (s_pModuleIndex, CD_MODULE_INDEX_GROUP, "language", g_get_language_names ()[0]);
+	s_bModuleIndexChanged = TRUE;
+}
+
+static void _save_module_index (void)
+{
+	if (! s_bModuleIndexChanged)
+		return;
+	gchar *cDirPath = g_path_get_dirname (s_cModuleIndexPath);
+	if (g_mkdir_with_parents (cDirPath, 0700) == 0)
+		cairo_dock_write_keys_to_file (s_pModuleIndex, s_cModuleIndexPath);
+	else
+		cd_warning ("couldn't create the folder '%s', the modules will not be indexed", cDirPath);
+	g_free (cDirPath);
+	s_bModuleIndexChanged = FALSE;
+}
+
+static inline const gchar *_get_index_string (const gchar *cGroupName, const gchar *cKey)
+{
+	gchar *cValue = g_key_file_get_string (s_pModuleIndex, cGroupName, cKey, NULL);
+	const gchar *cInternedValue = g_intern_string (cValue);  // the strings of a visit card are never freed.
+	g_free (cValue);
+	return cInternedValue;
+}
+static inline void _set_index_string (const gchar *cGroupName, const gchar *cKey, const gchar *cValue)
+{
+	if (cValue != NULL)
+		g_key_file_set_string (s_pModuleIndex, cGroupName, cKey, cValue);
+}
+
+// the entry of a library is valid as long as the file doesn't change.
+static gboolean _index_entry_is_valid (const gchar *cSoFilePath, struct stat *pStat)
+{
+	if (! g_key_file_has_group (s_pModuleIndex, cSoFilePath))
+		return FALSE;
+	gchar *cMTime = g_key_file_get_string (s_pModuleIndex, cSoFilePath, "mtime", NULL);
+	gchar *cSize = g_key_file_get_string (s_pModuleIndex, cSoFilePath, "size", NULL);
+	gboolean bValid = (cMTime != NULL && cSize != NULL
+		&& g_ascii_strtoll (cMTime, NULL, 10) == (gint64)pStat->st_mtime
+		&& g_ascii_strtoll (cSize, NULL, 10) == (gint64)pStat->st_size);
+	g_free (cMTime);
+	g_free (cSize);
+	return bValid;
+}
+
+static GldiVisitCard *_get_visit_card_from_index (const gchar *g)
+{
+	GldiVisitCard *pVisitCard = g_new0 (GldiVisitCard, 1);
+	pVisitCard->cModuleName = _get_index_string (g, "name");
+	pVisitCard->iMajorVersionNeeded = g_key_file_get_integer (s_pModuleIndex, g, "major", NULL);
+	pVisitCard->iMinorVersionNeeded = g_key_file_get_integer (s_pModuleIndex, g, "minor", NULL);
+	pVisitCard->iMicroVersionNeeded = g_key_file_get_integer (s_pModuleIndex, g, "micro", NULL);
+	pVisitCard->cPreviewFilePath = _get_index_string (g, "preview");
+	pVisitCard->cGettextDomain = _get_index_string (g, "gettext domain");
+	pVisitCard->cDockVersionOnCompilation = _get_index_string (g, "dock version");
+	pVisitCard->cModuleVersion = _get_index_string (g, "module version");
+	pVisitCard->cUserDataDir = _get_index_string (g, "user data dir");
+	pVisitCard->cShareDataDir = _get_index_string (g, "share data dir");
+	pVisitCard->cConfFileName = _get_index_string (g, "conf file");
+	pVisitCard->iCategory = g_key_file_get_integer (s_pModuleIndex, g, "category", NULL);
+	pVisitCard->cIconFilePath = _get_index_string (g, "icon");
+	pVisitCard->iSizeOfConfig = g_key_file_get_integer (s_pModuleIndex, g, "size of config", NULL);
+	pVisitCard->iSizeOfData = g_key_file_get_integer (s_pModuleIndex, g, "size of data", NULL);
+	pVisitCard->bMultiInstance = g_key_file_get_boolean (s_pModuleIndex, g, "multi-instance", NULL);
+	pVisitCard->cDescription = _get_index_string (g, "description");
+	pVisitCard->cAuthor = _get_index_string (g, "author");
+	pVisitCard->cTitle = _get_index_string (g, "title");
+	pVisitCard->iContainerType = g_key_file_get_integer (s_pModuleIndex, g, "container type", NULL);
+	pVisitCard->bStaticDeskletSize = g_key_file_get_boolean (s_pModuleIndex, g, "static desklet size", NULL);
+	pVisitCard->bAllowEmptyTitle = g_key_file_get_boolean (s_pModuleIndex, g, "allow empty title", NULL);
+	pVisitCard->bActAsLauncher = g_key_file_get_boolean (s_pModuleIndex, g, "act as launcher", NULL);
+	return pVisitCard;
+}
+
+static void _add_visit_card_to_index (const gchar *g, GldiVisitCard *pVisitCard, struct stat *pStat)
+{
+	g_key_file_remove_group (s_pModuleIndex, g, NULL);
+	gchar *str = g_strdup_printf ("%" G_GINT64_FORMAT, (gint64)pStat->st_mtime);
+	g_key_file_set_string (s_pModuleIndex, g, "mtime", str);
+	g_free (str);
+	str = g_strdup_printf ("%" G_GINT64_FORMAT, (gint64)pStat->st_size);
+	g_key_file_set_string (s_pModuleIndex, g, "size", str);
+	g_free (str);
+	_set_index_string (g, "name", pVisitCard->cModuleName);
+	g_key_file_set_integer (s_pModuleIndex, g, "major", pVisitCard->iMajorVersionNeeded);
+	g_key_file_set_integer (s_pModuleIndex, g, "minor", pVisitCard->iMinorVersionNeeded);
+	g_key_file_set_integer (s_pModuleIndex, g, "micro", pVisitCard->iMicroVersionNeeded);
+	_set_index_string (g, "preview", pVisitCard->cPreviewFilePath);
+	_set_index_string (g, "gettext domain", pVisitCard->cGettextDomain);
+	_set_index_string (g, "dock version", pVisitCard->cDockVersionOnCompilation);
+	_set_index_string (g, "module version", pVisitCard->cModuleVersion);
+	_set_index_string (g, "user data dir", pVisitCard->cUserDataDir);
+	_set_index_string (g, "share data dir", pVisitCard->cShareDataDir);
+	_set_index_string (g, "conf file", pVisitCard->cConfFileName);
+	g_key_file_set_integer (s_pModuleIndex, g, "category", pVisitCard->iCategory);
+	_set_index_string (g, "icon", pVisitCard->cIconFilePath);
+	g_key_file_set_integer (s_pModuleIndex, g, "size of config", pVisitCard->iSizeOfConfig);
+	g_key_file_set_integer (s_pModuleIndex, g, "size of data", pVisitCard->iSizeOfData);
+	g_key_file_set_boolean (s_pModuleIndex, g, "multi-instance", pVisitCard->bMultiInstance);
+	_set_index_string (g, "description", pVisitCard->cDescription);
+	_set_index_string (g, "author", pVisitCard->cAuthor);
+	_set_index_string (g, "title", pVisitCard->cTitle);
+	g_key_file_set_integer (s_pModuleIndex, g, "container type", pVisitCard->iContainerType);
+	g_key_file_set_boolean (s_pModuleIndex, g, "static desklet size", pVisitCard->bStaticDeskletSize);
+	g_key_file_set_boolean (s_pModuleIndex, g, "allow empty title", pVisitCard->bAllowEmptyTitle);
+	g_key_file_set_boolean (s_pModuleIndex, g, "act as launcher", pVisitCard->bActAsLauncher);
+	s_bModuleIndexChanged = TRUE;
+}
+
+static void _remove_from_index (const gchar *cSoFilePath)
+{
+	if (g_key_file_remove_group (s_pModuleIndex, cSoFilePath, NULL))
+		s_bModuleIndexChanged = TRUE;
+}
+
+GldiModule *gldi_module_new_from_so_file (const gchar *cSoFilePath)
+{
+	g_return_val_if_fail (cSoFilePath != NULL, NULL);
+	if (s_pModuleIndex == NULL)
+		_load_module_index ();
+	
+	// if the module is in the index, register it without opening its library; it will be done when it's activated.
+	struct stat st;
+	gboolean bCanIndex = (g_stat (cSoFilePath, &st) == 0);
+	if (bCanIndex && _index_entry_is_valid (cSoFilePath, &st))
 	{
-		cd_warning ("this module ('%s') was compiled with Cairo-Dock v%s, but Cairo-Dock is in v%s\n  It will be ignored", cSoFilePath, pVisitCard->cDockVersionOnCompilation, GLDI_VERSION);
-		goto discard;
+		GldiVisitCard *pVisitCard = _get_visit_card_from_index (cSoFilePath);
+		if (pVisitCard->cModuleName == NULL || ! _module_is_compatible (cSoFilePath, pVisitCard))
+		{
+			cairo_dock_free_visit_card (pVisitCard);
+			return NULL;
+		}
+		GldiModuleInterface *pInterface = g_new0 (GldiModuleInterface, 1);
+		pInterface->initModule = _init_module_from_index;
+		pInterface->stopModule = _stop_module_from_index;
+		GldiModule *pModule = gldi_module_new (pVisitCard, pInterface);  // takes ownership of pVisitCard and pInterface
+		if (pModule)
+			pModule->cSoFilePath = g_strdup (cSoFilePath);
+		return pModule;
+	}
+	
+	// otherwise open the library now
+	GldiVisitCard *pVisitCard = NULL;
+	GldiModuleInterface *pInterface = NULL;
+	gpointer handle = _open_module_library (cSoFilePath, &pVisitCard, &pInterface);
+	if (handle == NULL)
+	{
+		_remove_from_index (cSoFilePath);  // it may depend on the environment (for instance the xxx-integration modules), so it will be checked again next time.
+		return NULL;
+	}
+	
+	// index it, unless it has to be activated anyway (it would be useless) or its pre-init has to be run (to extend a manager).
+	if (bCanIndex)
+	{
+		if (pInterface->initModule == NULL || pInterface->stopModule == NULL || pVisitCard->cInternalModule != NULL)
+			_remove_from_index (cSoFilePath);
+		else
+			_add_visit_card_to_index (cSoFilePath, pVisitCard, &st);
 	}
 	
 	// create a new module with these info
 	GldiModule *pModule = gldi_module_new (pVisitCard, pInterface);  // takes ownership of pVisitCard and pInterface
 	if (pModule)
+	{
 		pModule->handle = handle;
+		pModule->cSoFilePath = g_strdup (cSoFilePath);
+	}
 	return pModule;
+}
+
+gboolean gldi_module_load (GldiModule *pModule)
+{
+	g_return_val_if_fail (pModule != NULL, FALSE);
+	if (pModule->handle != NULL || pModule->cSoFilePath == NULL)  // already loaded, or not provided by a library.
+		return TRUE;
+	cd_debug ("%s (%s)", __func__, pModule->cSoFilePath);
 	
-discard:
-	///g_module_close (pModule);
-	dlclose (handle);
-	cairo_dock_free_visit_card (pVisitCard);
+	GldiVisitCard *pVisitCard = NULL;
+	GldiModuleInterface *pInterface = NULL;
+	gpointer handle = _open_module_library (pModule->cSoFilePath, &pVisitCard, &pInterface);
+	if (handle == NULL)
+	{
+		cd_warning ("couldn't load the module '%s'", pModule->pVisitCard->cModuleName);
+		_remove_from_index (pModule->cSoFilePath);
+		_save_module_index ();
+		return FALSE;
+	}
+	if (g_strcmp0 (pVisitCard->cModuleName, pModule->pVisitCard->cModuleName) != 0)  // the library has been replaced since the dock was started.
+	{
+		cd_warning ("the module '%s' has been replaced by '%s', restart the dock to use it", pModule->pVisitCard->cModuleName, pVisitCard->cModuleName);
+		dlclose (handle);
+		cairo_dock_free_visit_card (pVisitCard);
+		g_free (pInterface);
+		return FALSE;
+	}
+	
+	// take the actual interface; the visit card from the index is kept, since other parts of the dock may already refer to it.
+	*pModule->pInterface = *pInterface;
 	g_free (pInterface);
-	return NULL;
+	cairo_dock_free_visit_card (pVisitCard);
+	pModule->handle = handle;
+	return TRUE;
 }
 
 static const char * const s_cWaylandExclude[] = {
@@ -263,6 +513,25 @@ void gldi_modules_new_from_directory (const gchar *cModuleDirPath, GError **erre
 	while (1);
 	g_string_free (sFilePath, TRUE);
 	g_dir_close (dir);
+	
+	// forget the libraries of this folder that have been removed, and save the changes.
+	if (s_pModuleIndex != NULL)
+	{
+		gchar **pGroups = g_key_file_get_groups (s_pModuleIndex, NULL);
+		gchar *cDirPath;
+		int i;
+		for (i = 0; pGroups[i] != NULL; i ++)
+		{
+			if (strcmp (pGroups[i], CD_MODULE_INDEX_GROUP) == 0)
+				continue;
+			cDirPath = g_path_get_dirname (pGroups[i]);
+			if (strcmp (cDirPath, cModuleDirPath) == 0 && ! g_file_test (pGroups[i], G_FILE_TEST_EXISTS))
+				_remove_from_index (pGroups[i]);
+			g_free (cDirPath);
+		}
+		g_strfreev (pGroups);
+		_save_module_index ();
+	}
 }
 
 gchar *gldi_module_get_config_dir (GldiModule *pModule)
@@ -314,6 +583,10 @@ void gldi_module_activate (GldiModule *module)
 		return ;
 	}
 	
+	// load its library if it has been registered from the index.
+	if (! gldi_module_load (module))
+		return ;
+	
 	if (module->pVisitCard->cConfFileName != NULL)  // the module has a conf file -> create an instance for each of them.
 	{
 		// check that the module's config dir exists or create it.
@@ -650,6 +923,7 @@ static void reset_object (GldiObject *obj)
 	// free data
 	if (pModule->handle)
 		dlclose (pModule->handle);
+	g_free (pModule->cSoFilePath);
 	g_free (pModule->pInterface);
 	cairo_dock_free_visit_card (pModule->pVisitCard);
 }
@@ -166,6 +166,8 @@ struct _GldiModule {
 	gpointer handle;
 	/// list of instances of the module.
 	GList *pInstancesList;
+	/// path to the dynamic library providing the module, or NULL.
+	gchar *cSoFilePath;
 	gpointer reserved[2];
 };
 
@@ -202,11 +204,18 @@ struct _CairoDockMinimalAppletConfig {
 GldiModule *gldi_module_new (GldiVisitCard *pVisitCard, GldiModuleInterface *pInterface);
 
 /** Create a new module from a .so file.
+* The visit cards of the modules are kept in an index, so that a module that has already been seen can be registered without opening its .so file; the file is then only opened when the module is activated (see \ref gldi_module_load). The index entry of a module is rebuilt when its .so file changes.
 * @param cSoFilePath path to the .so file
 * @return the new module, or NULL if an error occured.
 */
 GldiModule *gldi_module_new_from_so_file (const gchar *cSoFilePath);
 
+/** Make sure the dynamic library of a module is loaded, so that its interface can be used. This is done automatically when the module is activated.
+* @param pModule the module
+* @return TRUE if the interface of the module is available.
+*/
+gboolean gldi_module_load (GldiModule *pModule);
+
 /** Create new modules from all the .so files contained in the given folder.
 * @param cModuleDirPath path to the folder
 * @param erreur an error
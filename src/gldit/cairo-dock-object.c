@@ -17,6 +17,8 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>  // memmove
+
 #include "cairo-dock-struct.h"
 #include "cairo-dock-manager.h"
 #include "cairo-dock-log.h"
@@ -34,7 +36,7 @@ void gldi_object_set_manager (GldiObject *pObject, GldiObjectManager *pMgr)
 	pObject->mgr = pMgr;
 	pObject->mgrs = g_list_copy (pMgr->object.mgrs);
 	pObject->mgrs = g_list_append (pObject->mgrs, pMgr);
-	gldi_object_install_notifications (pObject, pMgr->object.pNotificationsTab->len);
+	gldi_object_install_notifications (pObject, pMgr->object.iNbNotifications);
 }
 void gldi_object_init (GldiObject *obj, GldiObjectManager *pMgr, gpointer attr)
 {
@@ -87,14 +89,13 @@ void gldi_object_unref (GldiObject *pObject)
 		}
 		
 		// clear notifications
-		GPtrArray *pNotificationsTab = pObject->pNotificationsTab;
 		guint i;
-		for (i = 0; i < pNotificationsTab->len; i ++)
+		for (i = 0; i < pObject->iNbNotifications; i ++)
 		{
-			GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, i);
-			g_slist_free_full (pNotificationRecordList, g_free);
+			g_free (pObject->pNotifications[i].pRecords);
+			g_slist_free_full (pObject->pNotifications[i].pPendingFirst, g_free);
 		}
-		g_ptr_array_free (pNotificationsTab, TRUE);
+		g_free (pObject->pNotifications);
 		
 		// free memory
 		g_free (pObject);
@@ -149,45 +150,133 @@ gboolean gldi_object_is_manager_child (GldiObject *pObject, GldiObjectManager *p
 }
 
 
+void _gldi_object_install_notifications (GldiObject *pObject, guint iNbNotifs)
+{
+	if (pObject->iNbNotifications >= iNbNotifs)
+		return;
+	pObject->pNotifications = g_renew (GldiNotificationList, pObject->pNotifications, iNbNotifs);
+	memset (&pObject->pNotifications[pObject->iNbNotifications], 0, (iNbNotifs - pObject->iNbNotifications) * sizeof (GldiNotificationList));
+	pObject->iNbNotifications = iNbNotifs;
+}
+
+static inline void _update_notifications_mask (GldiObject *pObject, GldiNotificationType iNotifType)
+{
+	if (iNotifType >= 64)
+		return;
+	GldiNotificationList *pList = &pObject->pNotifications[iNotifType];
+	if (pList->iNbRecords > pList->iNbRemoved || pList->pPendingFirst != NULL)
+		pObject->iNotificationsMask |= ((guint64)1 << iNotifType);
+	else
+		pObject->iNotificationsMask &= ~((guint64)1 << iNotifType);
+}
+
+static void _insert_record (GldiNotificationList *pList, guint iPosition, GldiNotificationFunc pFunction, gpointer pUserData)
+{
+	if (pList->iNbRecords == pList->iSize)
+	{
+		pList->iSize = MAX (4, 2 * pList->iSize);
+		pList->pRecords = g_renew (GldiNotificationRecord, pList->pRecords, pList->iSize);
+	}
+	memmove (&pList->pRecords[iPosition + 1], &pList->pRecords[iPosition], (pList->iNbRecords - iPosition) * sizeof (GldiNotificationRecord));
+	pList->pRecords[iPosition].pFunction = pFunction;
+	pList->pRecords[iPosition].pUserData = pUserData;
+	pList->iNbRecords ++;
+}
+
+void _gldi_notification_list_flush (GldiNotificationList *pList)
+{
+	// remove the records that have been cleared
+	if (pList->iNbRemoved != 0)
+	{
+		guint i, j = 0;
+		for (i = 0; i < pList->iNbRecords; i ++)
+		{
+			if (pList->pRecords[i].pFunction != NULL)
+				pList->pRecords[j++] = pList->pRecords[i];
+		}
+		pList->iNbRecords = j;
+		pList->iNbRemoved = 0;
+	}
+	// put the records that want to be called first at the beginning (the list is in reverse order of registration, like the array)
+	GldiNotificationRecord *pRecord;
+	GSList *r;
+	for (r = g_slist_reverse (pList->pPendingFirst); r != NULL; r = r->next)
+	{
+		pRecord = r->data;
+		_insert_record (pList, 0, pRecord->pFunction, pRecord->pUserData);
+	}
+	g_slist_free_full (pList->pPendingFirst, g_free);
+	pList->pPendingFirst = NULL;
+}
+
 void gldi_object_register_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gboolean bRunFirst, gpointer pUserData)
 {
 	g_return_if_fail (pObject != NULL);
-	// grab the notifications tab
-	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
-	if (!pNotificationsTab || pNotificationsTab->len < iNotifType)
+	// grab the list of callbacks
+	GldiObject *obj = GLDI_OBJECT(pObject);
+	if (iNotifType >= obj->iNbNotifications)
 	{
 		cd_warning ("someone tried to register to an inexisting notification (%d) on an object of type '%s'", iNotifType, gldi_object_get_type(pObject));
 		return ;  // don't try to create/resize the notifications tab, since noone will emit this notification.
 	}
+	GldiNotificationList *pList = &obj->pNotifications[iNotifType];
 	
 	// add a record
-	GldiNotificationRecord *pNotificationRecord = g_new (GldiNotificationRecord, 1);
-	pNotificationRecord->pFunction = pFunction;
-	pNotificationRecord->pUserData = pUserData;
-	
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
-	pNotificationsTab->pdata[iNotifType] = (bRunFirst ? g_slist_prepend : g_slist_append) (pNotificationRecordList, pNotificationRecord);
+	if (! bRunFirst)
+		_insert_record (pList, pList->iNbRecords, pFunction, pUserData);
+	else if (pList->iNbRunning == 0)
+		_insert_record (pList, 0, pFunction, pUserData);
+	else  // we're being broadcasted, don't move the records under its feet.
+	{
+		GldiNotificationRecord *pNotificationRecord = g_new (GldiNotificationRecord, 1);
+		pNotificationRecord->pFunction = pFunction;
+		pNotificationRecord->pUserData = pUserData;
+		pList->pPendingFirst = g_slist_prepend (pList->pPendingFirst, pNotificationRecord);
+	}
+	_update_notifications_mask (obj, iNotifType);
 }
 
 
 void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gpointer pUserData)
 {
 	g_return_if_fail (pObject != NULL);
-	// grab the notifications tab
-	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
+	// grab the list of callbacks
+	GldiObject *obj = GLDI_OBJECT(pObject);
+	g_return_if_fail (iNotifType < obj->iNbNotifications);
+	GldiNotificationList *pList = &obj->pNotifications[iNotifType];
 	
 	// remove the record
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
 	GldiNotificationRecord *pNotificationRecord;
+	guint i;
+	for (i = 0; i < pList->iNbRecords; i ++)
+	{
+		pNotificationRecord = &pList->pRecords[i];
+		if (pNotificationRecord->pFunction == pFunction && pNotificationRecord->pUserData == pUserData)
+		{
+			if (pList->iNbRunning != 0)  // we're being broadcasted, just clear the record, it will be removed afterwards.
+			{
+				pNotificationRecord->pFunction = NULL;
+				pList->iNbRemoved ++;
+			}
+			else
+			{
+				memmove (pNotificationRecord, pNotificationRecord + 1, (pList->iNbRecords - i - 1) * sizeof (GldiNotificationRecord));
+				pList->iNbRecords --;
+			}
+			_update_notifications_mask (obj, iNotifType);
+			return;
+		}
+	}
 	GSList *nr;
-	for (nr = pNotificationRecordList; nr != NULL; nr = nr->next)
+	for (nr = pList->pPendingFirst; nr != NULL; nr = nr->next)
 	{
 		pNotificationRecord = nr->data;
 		if (pNotificationRecord->pFunction == pFunction && pNotificationRecord->pUserData == pUserData)
 		{
-			pNotificationsTab->pdata[iNotifType] = g_slist_delete_link (pNotificationRecordList, nr);
+			pList->pPendingFirst = g_slist_delete_link (pList->pPendingFirst, nr);
 			g_free (pNotificationRecord);
-			break;
+			_update_notifications_mask (obj, iNotifType);
+			return;
 		}
 	}
 }
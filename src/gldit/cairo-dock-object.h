@@ -22,6 +22,7 @@
 
 #include <glib.h>
 #include "cairo-dock-struct.h"
+#include "cairo-dock-profiler.h"  // g_bProfilerEnabled
 
 G_BEGIN_DECLS
 
@@ -38,10 +39,14 @@ G_BEGIN_DECLS
 * To listen for notifications on any object of a given type, simply register yourself on its ObjectManager.
 */
 
+typedef struct _GldiNotificationList GldiNotificationList;
+
 /// Definition of an Object.
 struct _GldiObject {
 	gint ref;
-	GPtrArray *pNotificationsTab;
+	GldiNotificationList *pNotifications;  // callbacks of each type of notification
+	guint iNbNotifications;  // number of types of notification
+	guint64 iNotificationsMask;  // bit n is set if someone listens to the notification n on this object (notifications beyond 63 are always looked up).
 	GldiObjectManager *mgr;
 	GList *mgrs;  // sorted in reverse order
 };
@@ -119,6 +124,18 @@ typedef struct {
 
 typedef guint GldiNotificationType;
 
+/* The callbacks of a type of notification, in the order they are called. They are stored in an array so that going through them is cheap.
+ * A callback removed while the notification is being broadcasted is just cleared (its function is set to NULL), and the array is compacted once the broadcast is over; likewise a callback registered to be called first is put at the beginning of the array only once the broadcast is over.
+ */
+struct _GldiNotificationList {
+	GldiNotificationRecord *pRecords;
+	guint iNbRecords;
+	guint iSize;  // allocated size of the array
+	guint iNbRunning;  // number of broadcasts in progress
+	guint iNbRemoved;  // number of records cleared during a broadcast
+	GSList *pPendingFirst;  // records registered to be called first during a broadcast
+	};
+
 /// Use this in \ref gldi_object_register_notification to be called before the core.
 #define GLDI_RUN_FIRST TRUE
 /// Use this in \ref gldi_object_register_notification to be called after the core.
@@ -130,13 +147,8 @@ typedef guint GldiNotificationType;
 #define GLDI_NOTIFICATION_LET_PASS FALSE
 
 
-#define gldi_object_install_notifications(pObject, iNbNotifs) do {\
-	GPtrArray *pNotificationsTab = (GLDI_OBJECT(pObject))->pNotificationsTab;\
-	if (pNotificationsTab == NULL) {\
-		pNotificationsTab = g_ptr_array_new ();\
-		(GLDI_OBJECT(pObject))->pNotificationsTab = pNotificationsTab; }\
-	if (pNotificationsTab->len < iNbNotifs)\
-		g_ptr_array_set_size (pNotificationsTab, iNbNotifs); } while (0)
+void _gldi_object_install_notifications (GldiObject *pObject, guint iNbNotifs);
+#define gldi_object_install_notifications(pObject, iNbNotifs) _gldi_object_install_notifications (GLDI_OBJECT(pObject), iNbNotifs)
 
 /** Register an action to be called when a given notification is broadcasted from a given object.
 *@param pObject the object (Icon, Container, Manager).
@@ -148,7 +160,7 @@ typedef guint GldiNotificationType;
 void gldi_object_register_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gboolean bRunFirst, gpointer pUserData);
 
 /** Remove a callback from the list of callbacks of a given object for a given notification and a given data.
-Note: it is safe to remove the callback when it is called, but not another one.
+Note: it is safe to remove any callback while the notification is being broadcasted.
 *@param pObject the object (Icon, Container, Manager) for which the action has been registered.
 *@param iNotifType type of the notification.
 *@param pFunction callback.
@@ -157,23 +169,52 @@ Note: it is safe to remove the callback when it is called, but not another one.
 void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gpointer pUserData);
 
 
-#define __notify(pNotificationRecordList, bStop, ...) do {\
+// called at the end of a broadcast, to apply the changes made to the list meanwhile.
+void _gldi_notification_list_flush (GldiNotificationList *pList);
+
+// the records registered during the broadcast are not called, and the removed ones are skipped.
+#define __notify(pList, bStop, ...) do {\
+	GldiNotificationRecord *pNotificationRecord;\
+	guint _n, _iNbRecords = pList->iNbRecords;\
+	pList->iNbRunning ++;\
+	for (_n = 0; _n < _iNbRecords && ! bStop; _n ++) {\
+		pNotificationRecord = &pList->pRecords[_n];\
+		if (pNotificationRecord->pFunction != NULL)\
+			bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__); }\
+	if (-- pList->iNbRunning == 0 && (pList->iNbRemoved != 0 || pList->pPendingFirst != NULL))\
+		_gldi_notification_list_flush (pList);\
+	} while (0)
+
+// same as above, but measures the time spent in each callback.
+#define __notify_profiled(pList, bStop, cObjectType, iNotifType, ...) do {\
 	GldiNotificationRecord *pNotificationRecord;\
-	GSList *pElement = pNotificationRecordList, *pNextElement;\
-	while (pElement != NULL && ! bStop) {\
-		pNotificationRecord = pElement->data;\
-		pNextElement = pElement->next;\
-		bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
-		pElement = pNextElement; }\
+	GldiNotificationFunc _pFunction;\
+	gint64 _iStartTime;\
+	guint _n, _iNbRecords = pList->iNbRecords;\
+	pList->iNbRunning ++;\
+	for (_n = 0; _n < _iNbRecords && ! bStop; _n ++) {\
+		pNotificationRecord = &pList->pRecords[_n];\
+		_pFunction = pNotificationRecord->pFunction;\
+		if (_pFunction == NULL)\
+			continue;\
+		_iStartTime = g_get_monotonic_time ();\
+		bStop = _pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
+		gldi_profiler_record_notification (cObjectType, iNotifType, (gpointer)_pFunction, g_get_monotonic_time () - _iStartTime); }\
+	if (-- pList->iNbRunning == 0 && (pList->iNbRemoved != 0 || pList->pPendingFirst != NULL))\
+		_gldi_notification_list_flush (pList);\
 	} while (0)
 
+// an object without any listener for this notification costs only a bit test.
 #define __notify_on_object(pObject, iNotifType, ...) \
 	__extension__ ({\
 	gboolean _stop = FALSE;\
-	GPtrArray *pNotificationsTab = (pObject)->pNotificationsTab;\
-	if (pNotificationsTab && iNotifType < pNotificationsTab->len) {\
-		GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);\
-		__notify (pNotificationRecordList, _stop, ##__VA_ARGS__);} \
+	if (iNotifType < (pObject)->iNbNotifications) {\
+		if (iNotifType >= 64 || ((pObject)->iNotificationsMask & ((guint64)1 << iNotifType))) {\
+			GldiNotificationList *_pList = &(pObject)->pNotifications[iNotifType];\
+			if (G_UNLIKELY (g_bProfilerEnabled))\
+				__notify_profiled (_pList, _stop, gldi_object_get_type (pObject), iNotifType, ##__VA_ARGS__);\
+			else\
+				__notify (_pList, _stop, ##__VA_ARGS__);} }\
 	else {_stop = TRUE;}\
 	_stop; })
 
@@ -185,10 +226,15 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 #define gldi_object_notify(pObject, iNotifType, ...) \
 	__extension__ ({\
 	gboolean _bStop = FALSE;\
-	GldiObject *_obj = GLDI_OBJECT (pObject);\
+	GldiObject *_pNotifiedObject = GLDI_OBJECT (pObject), *_obj = _pNotifiedObject;\
+	gboolean _bRef = (_obj && _obj->ref > 0);  /* a callback may destroy the object, so keep it alive until the broadcast is over (an object being destroyed has no reference left to take) */\
+	if (_bRef) _obj->ref ++;\
 	while (_obj && !_bStop) {\
 		_bStop = __notify_on_object (_obj, iNotifType, ##__VA_ARGS__);\
 		_obj = GLDI_OBJECT (_obj->mgr); }\
+	if (_bRef) {\
+		if (_pNotifiedObject->ref == 1) gldi_object_unref (_pNotifiedObject);\
+		else _pNotifiedObject->ref --; }\
 	})
 
 
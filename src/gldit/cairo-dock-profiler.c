@@ -0,0 +1,304 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <dbus/dbus-glib-lowlevel.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-dbus.h"
+#include "cairo-dock-image-cache.h"
+#include "cairo-dock-profiler.h"
+
+#define GLDI_PROFILER_DBUS_PATH "/org/cairodock/CairoDock/Profiler"
+#define GLDI_PROFILER_DBUS_INTERFACE "org.cairodock.CairoDock.Profiler"
+#define GLDI_PROFILER_NB_ITEMS_IN_REPORT 20  // per category
+
+typedef struct {
+	gchar *cName;
+	guint64 iCount;
+	gint64 iTotalTime;  // in us
+	gint64 iMaxTime;
+	} GldiProfilerEntry;
+
+gboolean g_bProfilerEnabled = FALSE;
+
+static GHashTable *s_pEntries[GLDI_PROFILER_NB_CATEGORIES];  // name -> entry, for each category
+static GMutex s_mutex;  // measures can come from the threads of the Tasks
+static gint64 s_iStartTime = 0;  // time of the last reset
+static guint s_iSidDump = 0;
+
+static const gchar *s_cCategoryNames[GLDI_PROFILER_NB_CATEGORIES] = {
+	"Frames drawn",
+	"Animation loop iterations",
+	"Animated icons",
+	"Notification callbacks",
+	"Tasks (asynchronous phase)",
+	"Tasks (synchronous phase)"};
+
+static void _free_entry (GldiProfilerEntry *pEntry)
+{
+	g_free (pEntry->cName);
+	g_free (pEntry);
+}
+
+
+  ////////////////
+ /// MEASURES ///
+////////////////
+
+void gldi_profiler_record (GldiProfilerCategory iCategory, const gchar *cName, gint64 iDuration)
+{
+	g_return_if_fail (iCategory < GLDI_PROFILER_NB_CATEGORIES);
+	if (cName == NULL)
+		cName = "?";
+	g_mutex_lock (&s_mutex);
+	if (s_pEntries[iCategory] == NULL)
+		s_pEntries[iCategory] = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify)_free_entry);  // the key belongs to the entry
+	GldiProfilerEntry *pEntry = g_hash_table_lookup (s_pEntries[iCategory], cName);
+	if (pEntry == NULL)
+	{
+		pEntry = g_new0 (GldiProfilerEntry, 1);
+		pEntry->cName = g_strdup (cName);
+		g_hash_table_insert (s_pEntries[iCategory], pEntry->cName, pEntry);
+	}
+	pEntry->iCount ++;
+	pEntry->iTotalTime += iDuration;
+	if (iDuration > pEntry->iMaxTime)
+		pEntry->iMaxTime = iDuration;
+	g_mutex_unlock (&s_mutex);
+}
+
+void gldi_profiler_record_function (GldiProfilerCategory iCategory, const gchar *cContext, gpointer pFunction, gint64 iDuration)
+{
+	gchar cName[128];  // no allocation, this is called very often
+	if (cContext != NULL)
+		g_snprintf (cName, sizeof (cName), "%s %p", cContext, pFunction);
+	else
+		g_snprintf (cName, sizeof (cName), "%p", pFunction);
+	gldi_profiler_record (iCategory, cName, iDuration);
+}
+
+void gldi_profiler_record_notification (const gchar *cObjectType, guint iNotifType, gpointer pFunction, gint64 iDuration)
+{
+	gchar cName[128];
+	g_snprintf (cName, sizeof (cName), "%s #%u %p", cObjectType, iNotifType, pFunction);
+	gldi_profiler_record (GLDI_PROFILER_NOTIFICATION, cName, iDuration);
+}
+
+void gldi_profiler_reset (void)
+{
+	g_mutex_lock (&s_mutex);
+	int i;
+	for (i = 0; i < GLDI_PROFILER_NB_CATEGORIES; i ++)
+	{
+		if (s_pEntries[i] != NULL)
+			g_hash_table_remove_all (s_pEntries[i]);
+	}
+	s_iStartTime = g_get_monotonic_time ();
+	g_mutex_unlock (&s_mutex);
+}
+
+void gldi_profiler_set_enabled (gboolean bEnable)
+{
+	if (bEnable && ! g_bProfilerEnabled)
+		gldi_profiler_reset ();
+	g_bProfilerEnabled = bEnable;
+	cd_message ("profiler %s", bEnable ? "enabled" : "disabled");
+}
+
+
+  //////////////
+ /// REPORT ///
+//////////////
+
+static gint _compare_entries (const GldiProfilerEntry *e1, const GldiProfilerEntry *e2)
+{
+	if (e1->iTotalTime != e2->iTotalTime)
+		return (e1->iTotalTime < e2->iTotalTime ? 1 : -1);
+	if (e1->iCount != e2->iCount)
+		return (e1->iCount < e2->iCount ? 1 : -1);
+	return strcmp (e1->cName, e2->cName);
+}
+
+gchar *gldi_profiler_get_report (void)
+{
+	GString *sReport = g_string_new ("");
+	g_mutex_lock (&s_mutex);
+	double fElapsedTime = (s_iStartTime != 0 ? (g_get_monotonic_time () - s_iStartTime) / 1e6 : 0.);
+	g_string_append_printf (sReport, "Profile over the last %.1fs (%s):\n", fElapsedTime, g_bProfilerEnabled ? "recording" : "stopped");
+
+	int i;
+	for (i = 0; i < GLDI_PROFILER_NB_CATEGORIES; i ++)
+	{
+		if (s_pEntries[i] == NULL || g_hash_table_size (s_pEntries[i]) == 0)
+			continue;
+		g_string_append_printf (sReport, " %s:\n  %10s %8s %10s %8s  %s\n", s_cCategoryNames[i], "count", "per s", "total(ms)", "max(ms)", "name");
+
+		GList *pEntries = g_list_sort (g_hash_table_get_values (s_pEntries[i]), (GCompareFunc)_compare_entries);
+		GList *e;
+		int n;
+		GldiProfilerEntry *pEntry;
+		for (e = pEntries, n = 0; e != NULL && n < GLDI_PROFILER_NB_ITEMS_IN_REPORT; e = e->next, n ++)
+		{
+			pEntry = e->data;
+			g_string_append_printf (sReport, "  %10"G_GUINT64_FORMAT" %8.1f %10.1f %8.2f  %s\n",
+				pEntry->iCount,
+				fElapsedTime > 0 ? pEntry->iCount / fElapsedTime : 0.,
+				pEntry->iTotalTime / 1e3,
+				pEntry->iMaxTime / 1e3,
+				pEntry->cName);
+		}
+		if (e != NULL)
+			g_string_append_printf (sReport, "  ... (%d more)\n", g_list_length (e));
+		g_list_free (pEntries);
+	}
+	g_mutex_unlock (&s_mutex);
+
+	CairoDockImageCacheStats stats;
+	cairo_dock_image_cache_get_stats (&stats);
+	g_string_append_printf (sReport, " Image cache: %u hits, %u misses, %u stores, %u evictions, %u entries (%"G_GSIZE_FORMAT" bytes)\n",
+		stats.iNbHits, stats.iNbMisses, stats.iNbStores, stats.iNbEvictions, stats.iNbEntries, stats.iTotalSize);
+
+	return g_string_free (sReport, FALSE);
+}
+
+static gboolean _dump_report (G_GNUC_UNUSED gpointer data)
+{
+	gchar *cReport = gldi_profiler_get_report ();
+	g_print ("%s", cReport);  // the user asked for it, so don't depend on the verbosity.
+	g_free (cReport);
+	return TRUE;
+}
+
+void gldi_profiler_set_dump_interval (gint iSeconds)
+{
+	if (s_iSidDump != 0)
+	{
+		g_source_remove (s_iSidDump);
+		s_iSidDump = 0;
+	}
+	if (iSeconds > 0)
+		s_iSidDump = g_timeout_add_seconds (iSeconds, (GSourceFunc) _dump_report, NULL);
+}
+
+
+  ////////////
+ /// DBUS ///
+////////////
+
+static const gchar *s_cIntrospectionXml =
+	"<!DOCTYPE node PUBLIC \"-//freedesktop//DTD D-BUS Object Introspection 1.0//EN\" \"http://www.freedesktop.org/standards/dbus/1.0/introspect.dtd\">\n"
+	"<node>\n"
+	" <interface name=\"org.freedesktop.DBus.Introspectable\">\n"
+	"  <method name=\"Introspect\"><arg name=\"data\" direction=\"out\" type=\"s\"/></method>\n"
+	" </interface>\n"
+	" <interface name=\""GLDI_PROFILER_DBUS_INTERFACE"\">\n"
+	"  <method name=\"Enable\"><arg name=\"enable\" direction=\"in\" type=\"b\"/></method>\n"
+	"  <method name=\"Reset\"/>\n"
+	"  <method name=\"SetDumpInterval\"><arg name=\"seconds\" direction=\"in\" type=\"i\"/></method>\n"
+	"  <method name=\"GetReport\"><arg name=\"report\" direction=\"out\" type=\"s\"/></method>\n"
+	" </interface>\n"
+	"</node>\n";
+
+static DBusHandlerResult _on_dbus_message (DBusConnection *pConnection, DBusMessage *pMessage, G_GNUC_UNUSED void *data)
+{
+	DBusMessage *pReply = NULL;
+	if (dbus_message_is_method_call (pMessage, GLDI_PROFILER_DBUS_INTERFACE, "GetReport"))
+	{
+		gchar *cReport = gldi_profiler_get_report ();
+		pReply = dbus_message_new_method_return (pMessage);
+		dbus_message_append_args (pReply, DBUS_TYPE_STRING, &cReport, DBUS_TYPE_INVALID);
+		g_free (cReport);
+	}
+	else if (dbus_message_is_method_call (pMessage, GLDI_PROFILER_DBUS_INTERFACE, "Enable"))
+	{
+		dbus_bool_t bEnable;
+		if (dbus_message_get_args (pMessage, NULL, DBUS_TYPE_BOOLEAN, &bEnable, DBUS_TYPE_INVALID))
+		{
+			gldi_profiler_set_enabled (bEnable);
+			pReply = dbus_message_new_method_return (pMessage);
+		}
+		else
+			pReply = dbus_message_new_error (pMessage, DBUS_ERROR_INVALID_ARGS, "expected a boolean");
+	}
+	else if (dbus_message_is_method_call (pMessage, GLDI_PROFILER_DBUS_INTERFACE, "SetDumpInterval"))
+	{
+		dbus_int32_t iSeconds;
+		if (dbus_message_get_args (pMessage, NULL, DBUS_TYPE_INT32, &iSeconds, DBUS_TYPE_INVALID))
+		{
+			gldi_profiler_set_dump_interval (iSeconds);
+			pReply = dbus_message_new_method_return (pMessage);
+		}
+		else
+			pReply = dbus_message_new_error (pMessage, DBUS_ERROR_INVALID_ARGS, "expected an integer");
+	}
+	else if (dbus_message_is_method_call (pMessage, GLDI_PROFILER_DBUS_INTERFACE, "Reset"))
+	{
+		gldi_profiler_reset ();
+		pReply = dbus_message_new_method_return (pMessage);
+	}
+	else if (dbus_message_is_method_call (pMessage, DBUS_INTERFACE_INTROSPECTABLE, "Introspect"))
+	{
+		pReply = dbus_message_new_method_return (pMessage);
+		dbus_message_append_args (pReply, DBUS_TYPE_STRING, &s_cIntrospectionXml, DBUS_TYPE_INVALID);
+	}
+	else
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	if (pReply != NULL)
+	{
+		dbus_connection_send (pConnection, pReply, NULL);
+		dbus_message_unref (pReply);
+	}
+	return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+static void _register_on_bus (void)
+{
+	DBusGConnection *pGConnection = cairo_dock_get_session_connection ();
+	if (pGConnection == NULL)
+		return;
+	static const DBusObjectPathVTable vtable = {NULL, _on_dbus_message, NULL, NULL, NULL, NULL};
+	if (! dbus_connection_register_object_path (dbus_g_connection_get_connection (pGConnection), GLDI_PROFILER_DBUS_PATH, &vtable, NULL))
+		cd_warning ("couldn't register the profiler on the bus");
+}
+
+
+  ////////////
+ /// INIT ///
+////////////
+
+void gldi_profiler_init (void)
+{
+	static gboolean bInitDone = FALSE;
+	if (bInitDone)
+		return;
+	bInitDone = TRUE;
+
+	const gchar *cInterval = g_getenv ("CAIRO_DOCK_PROFILE");
+	if (cInterval != NULL)
+	{
+		gldi_profiler_set_enabled (TRUE);
+		gldi_profiler_set_dump_interval (atoi (cInterval));
+	}
+
+	_register_on_bus ();
+}
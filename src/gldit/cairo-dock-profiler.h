@@ -0,0 +1,101 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_PROFILER__
+#define  __CAIRO_DOCK_PROFILER__
+
+#include <glib.h>
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-profiler.h This class implements a light profiler, to find out why the dock wakes up and where its time goes.
+* It counts the frames drawn by each dock, the iterations of their animation loop and the icons that keep it running, and measures the time spent in each notification callback and in the 2 phases of each Task.
+*
+* The profiler is disabled by default and costs nothing then. It can be enabled with the CAIRO_DOCK_PROFILE environment variable (its value is the interval in seconds at which the results are dumped on the terminal, 0 to never dump them), or on the session bus, with the methods Enable, Reset and GetReport of the interface org.cairodock.CairoDock.Profiler on the object /org/cairodock/CairoDock/Profiler.
+*/
+
+/// Categories of measures.
+typedef enum {
+	/// frames drawn, per dock
+	GLDI_PROFILER_FRAME = 0,
+	/// iterations of the animation loop, per dock
+	GLDI_PROFILER_ANIMATION_LOOP,
+	/// iterations during which an icon was animated, per icon
+	GLDI_PROFILER_ANIMATING_ICON,
+	/// calls to a notification callback, per callback
+	GLDI_PROFILER_NOTIFICATION,
+	/// asynchronous phase of a Task, per Task
+	GLDI_PROFILER_TASK_GET_DATA,
+	/// synchronous phase of a Task, per Task
+	GLDI_PROFILER_TASK_UPDATE,
+	GLDI_PROFILER_NB_CATEGORIES
+	} GldiProfilerCategory;
+
+/// TRUE when the profiler is recording; test it before measuring anything.
+extern gboolean g_bProfilerEnabled;
+
+/** Initialize the profiler: read the CAIRO_DOCK_PROFILE environment variable and make the profiler available on the session bus.
+*/
+void gldi_profiler_init (void);
+
+/** Start or stop recording. The measures are kept when the recording is stopped.
+*@param bEnable TRUE to record.
+*/
+void gldi_profiler_set_enabled (gboolean bEnable);
+
+/** Forget all the measures.
+*/
+void gldi_profiler_reset (void);
+
+/** Dump the results on the terminal periodically.
+*@param iSeconds interval between 2 dumps, 0 to stop dumping.
+*/
+void gldi_profiler_set_dump_interval (gint iSeconds);
+
+/** Add a measure. It can be called from any thread.
+*@param iCategory category of the measure.
+*@param cName name of the measured item (a dock, an icon...).
+*@param iDuration time spent, in microseconds (0 to just count an event).
+*/
+void gldi_profiler_record (GldiProfilerCategory iCategory, const gchar *cName, gint64 iDuration);
+
+/** Add a measure about a function (callback, Task phase...), which is identified by its address. It can be called from any thread.
+*@param iCategory category of the measure.
+*@param cContext a hint about what the function is called for, or NULL.
+*@param pFunction the function.
+*@param iDuration time spent, in microseconds.
+*/
+void gldi_profiler_record_function (GldiProfilerCategory iCategory, const gchar *cContext, gpointer pFunction, gint64 iDuration);
+
+/** Add a measure about a notification callback. It is done by \ref gldi_object_notify when the profiler is recording.
+*@param cObjectType type of the object on which the notification was broadcasted.
+*@param iNotifType type of the notification.
+*@param pFunction the callback.
+*@param iDuration time spent in the callback, in microseconds.
+*/
+void gldi_profiler_record_notification (const gchar *cObjectType, guint iNotifType, gpointer pFunction, gint64 iDuration);
+
+/** Get a readable summary of the measures since the last reset, the most expensive items first.
+*@return a newly allocated string.
+*/
+gchar *gldi_profiler_get_report (void);
+
+G_END_DECLS
+#endif
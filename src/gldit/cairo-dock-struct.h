@@ -414,6 +414,7 @@ typedef struct _CairoDataRenderer CairoDataRenderer;
 typedef struct _CairoDataRendererAttribute CairoDataRendererAttribute;
 typedef struct _CairoDataRendererInterface CairoDataRendererInterface;
 typedef struct _CairoDataToRenderer CairoDataToRenderer;
+typedef struct _CairoDataRendererQueue CairoDataRendererQueue;
 typedef struct _CairoDataRendererEmblemParam CairoDataRendererEmblemParam;
 typedef struct _CairoDataRendererEmblem CairoDataRendererEmblem;
 typedef struct _CairoDataRendererTextParam CairoDataRendererTextParam;
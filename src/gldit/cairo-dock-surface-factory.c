@@ -29,12 +29,15 @@
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-icon-manager.h"  // cairo_dock_search_icon_s_path
 #include "cairo-dock-dialog-manager.h"
-#include "cairo-dock-style-manager.h"
+#include "cairo-dock-style-manager.h"  // gldi_style_colors_get_stamp
+#include "cairo-dock-image-cache.h"
 #include "cairo-dock-surface-factory.h"
 
 extern GldiContainer *g_pPrimaryContainer;
 extern gboolean g_bUseOpenGL;
 
+static GPrivate s_forcedDeviceScale = G_PRIVATE_INIT (NULL);  // set while loading an image outside of the main thread: blank surfaces are then plain image surfaces with this scale.
+
 
 /* Calcule la taille d'une image selon une contrainte en largeur et hauteur de manière à remplir l'espace donné.
 *@param fImageWidth the width of the image. Contient initialement the width of the image, et sera écrasée avec la largeur obtenue.
@@ -187,8 +190,28 @@ static inline cairo_t *_get_source_context (void)
 	return pSourceContext;  // Note: we can't keep the context alive and reuse it later, because under Wayland it will make the container invisible
 }
 
+static PangoLayout *s_pTextLayout = NULL;  // reused for all the texts, it only needs to be updated to the current context.
+
+static PangoLayout *_get_text_layout (cairo_t *pSourceContext)
+{
+	if (s_pTextLayout == NULL)
+		s_pTextLayout = pango_cairo_create_layout (pSourceContext);
+	else
+		pango_cairo_update_layout (pSourceContext, s_pTextLayout);
+	return s_pTextLayout;
+}
+
 cairo_surface_t *cairo_dock_create_blank_surface_full (int iWidth, int iHeight, cairo_t *pSourceContext)
 {
+	double *pForcedScale = g_private_get (&s_forcedDeviceScale);
+	if (pForcedScale != NULL)  // we're not in the main thread, don't touch the widgets.
+	{
+		double fScale = *pForcedScale;
+		cairo_surface_t *pImageSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, (int)ceil(iWidth * fScale), (int)ceil(iHeight * fScale));
+		cairo_surface_set_device_scale (pImageSurface, fScale, fScale);
+		return pImageSurface;
+	}
+	
 	cairo_t *tmpContext = NULL;
 	if (!pSourceContext && !g_bUseOpenGL)
 		pSourceContext = tmpContext = _get_source_context ();
@@ -275,10 +298,25 @@ static inline void _apply_orientation_and_scale (cairo_t *pCairoContext, CairoDo
 }
 
 
+// premultiply the color components by the alpha (needed by libcairo), with integers only: x*a/255 is computed as (t + t/256) / 256 with t = x*a + 128, which is exact, and red and blue are processed together.
+static inline guint32 _premultiply_argb (guint32 pixel)
+{
+	guint32 alpha = pixel >> 24;
+	if (alpha == 0xFF)
+		return pixel;
+	guint32 rb = (pixel & 0x00FF00FF) * alpha + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+	guint32 g = (pixel & 0x0000FF00) * alpha + 0x00008000;
+	g = ((g + ((g >> 8) & 0x0000FF00)) >> 8) & 0x0000FF00;
+	return (pixel & 0xFF000000) | rb | g;
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
 {
-	//\____________________ On recupere la plus grosse des icones presentes dans le tampon (meilleur rendu).
+	//\____________________ On recupere la plus petite des icones au moins aussi grande que la taille voulue (meilleur rendu), ou sinon la plus grosse.
+	gulong iTargetSize = MAX (iWidth, iHeight);
 	int iIndex = 0, iBestIndex = 0;
+	gulong iSize, iBestSize = 0;
 	while (iIndex + 2 < iBufferNbElements)
 	{
 		if (pXIconBuffer[iIndex] == 0 || pXIconBuffer[iIndex+1] == 0)  // precaution au cas ou un buffer foirreux nous serait retourne, on risque de boucler sans fin.
@@ -288,8 +326,14 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 				return NULL;
 			break;
 		}
-		if (pXIconBuffer[iIndex] > pXIconBuffer[iBestIndex])
+		iSize = MAX (pXIconBuffer[iIndex], pXIconBuffer[iIndex+1]);
+		if (iBestSize == 0
+		|| (iSize >= iTargetSize && (iSize < iBestSize || iBestSize < iTargetSize))
+		|| (iSize < iTargetSize && iSize > iBestSize && iBestSize < iTargetSize))
+		{
 			iBestIndex = iIndex;
+			iBestSize = iSize;
+		}
 		iIndex += 2 + pXIconBuffer[iIndex] * pXIconBuffer[iIndex+1];
 	}
 
@@ -305,25 +349,13 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 		cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
 		return NULL;
 	}
-	gint pixel, alpha, red, green, blue;
-	float fAlphaFactor;
-	gint *pPixelBuffer = (gint *) &pXIconBuffer[iBestIndex];  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(gint), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
+	gulong *pXPixels = &pXIconBuffer[iBestIndex];
+	guint32 *pPixelBuffer = (guint32 *) pXPixels;  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(guint32), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
 	for (i = 0; i < n; i ++)
-	{
-		pixel = (gint) pXIconBuffer[iBestIndex+i];
-		alpha = (pixel & 0xFF000000) >> 24;
-		red   = (pixel & 0x00FF0000) >> 16;
-		green = (pixel & 0x0000FF00) >> 8;
-		blue  = (pixel & 0x000000FF);
-		fAlphaFactor = (float) alpha / 255;
-		red *= fAlphaFactor;
-		green *= fAlphaFactor;
-		blue *= fAlphaFactor;
-		pPixelBuffer[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
-	}
+		pPixelBuffer[i] = _premultiply_argb ((guint32) pXPixels[i]);
 
 	//\____________________ On cree la surface a partir du tampon.
-	int iStride = w * sizeof (gint);  // nbre d'octets entre le debut de 2 lignes.
+	int iStride = w * sizeof (guint32);  // nbre d'octets entre le debut de 2 lignes.
 	cairo_surface_t *surface_ini = cairo_image_surface_create_for_data ((guchar *)pPixelBuffer,
 		CAIRO_FORMAT_ARGB32,
 		w,
@@ -442,10 +474,9 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 }
 
 
-cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+static cairo_surface_t *_cairo_dock_load_surface_from_image_file (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
 {
 	//g_print ("%s (%s, %dx%dx%.2f, %d)\n", __func__, cImagePath, iWidthConstraint, iHeightConstraint, fMaxScale, iLoadingModifier);
-	g_return_val_if_fail (cImagePath != NULL, NULL);
 	GError *erreur = NULL;
 	RsvgDimensionData rsvg_dimension_data;
 	RsvgHandle *rsvg_handle = NULL;
@@ -602,6 +633,71 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 	return pNewSurface;
 }
 
+// the device scale of the surfaces made by 'cairo_dock_create_blank_surface'; outside of the main thread, it's the one given by the caller.
+static double _get_device_scale (void)
+{
+	double *pForcedScale = g_private_get (&s_forcedDeviceScale);
+	if (pForcedScale != NULL)
+		return *pForcedScale;
+	double fScale = 1.;
+	if (g_pPrimaryContainer != NULL)
+	{
+		GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
+		if (gdkwindow != NULL)
+			fScale = gdk_window_get_scale_factor (gdkwindow);
+	}
+	return fScale;
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	g_return_val_if_fail (cImagePath != NULL, NULL);
+	double fZoomWidth = 1., fZoomHeight = 1.;
+	double fDeviceScale = _get_device_scale ();
+	
+	//\_______________ first look in the cache, decoding an image (especially a SVG) is much slower than mapping its pixels.
+	cairo_surface_t *pNewSurface = cairo_dock_image_cache_lookup (cImagePath,
+		fMaxScale,
+		iWidthConstraint,
+		iHeightConstraint,
+		iLoadingModifier,
+		fDeviceScale,
+		fImageWidth,
+		fImageHeight,
+		&fZoomWidth,
+		&fZoomHeight);
+	if (pNewSurface == NULL)
+	{
+		pNewSurface = _cairo_dock_load_surface_from_image_file (cImagePath,
+			fMaxScale,
+			iWidthConstraint,
+			iHeightConstraint,
+			iLoadingModifier,
+			fImageWidth,
+			fImageHeight,
+			&fZoomWidth,
+			&fZoomHeight);
+		if (pNewSurface != NULL)
+			cairo_dock_image_cache_store (cImagePath,
+				fMaxScale,
+				iWidthConstraint,
+				iHeightConstraint,
+				iLoadingModifier,
+				fDeviceScale,
+				pNewSurface,
+				*fImageWidth,
+				*fImageHeight,
+				fZoomWidth,
+				fZoomHeight);
+	}
+	
+	if (fZoomX != NULL)
+		*fZoomX = fZoomWidth;
+	if (fZoomY != NULL)
+		*fZoomY = fZoomHeight;
+	return pNewSurface;
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight)
 {
 	g_return_val_if_fail (cImageFile != NULL, NULL);
@@ -626,6 +722,16 @@ cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImag
 	return pSurface;
 }
 
+cairo_surface_t *cairo_dock_create_image_surface_from_image_simple (const gchar *cImagePath, double fImageWidth, double fImageHeight, double fDeviceScale)
+{
+	g_return_val_if_fail (cImagePath != NULL && *cImagePath == '/', NULL);
+	double fScale = (fDeviceScale > 0 ? fDeviceScale : 1.);
+	g_private_set (&s_forcedDeviceScale, &fScale);
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_image_simple (cImagePath, fImageWidth, fImageHeight);
+	g_private_set (&s_forcedDeviceScale, NULL);
+	return pSurface;
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_icon (const gchar *cImageFile, double fImageWidth, double fImageHeight)
 {
 	g_return_val_if_fail (cImageFile != NULL, NULL);
@@ -755,14 +861,17 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	int iSize = gldi_text_description_get_size (pTextDescription);
 	pango_font_description_set_absolute_size (pDesc, fMaxScale * iSize * PANGO_SCALE);
 	
-	//\_________________ create a layout
-	PangoLayout *pLayout = pango_cairo_create_layout (pSourceContext);
+	//\_________________ set up the layout
+	PangoLayout *pLayout = _get_text_layout (pSourceContext);
 	pango_layout_set_font_description (pLayout, pDesc);
 	
 	if (pTextDescription->bUseMarkup)
 		pango_layout_set_markup (pLayout, cText, -1);
 	else
+	{
+		pango_layout_set_attributes (pLayout, NULL);  // remove the attributes of a previous markup
 		pango_layout_set_text (pLayout, cText, -1);
+	}
 	
 	//\_________________ handle max width
 	if (pTextDescription->fMaxRelativeWidth != 0)
@@ -770,6 +879,8 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 		int iMaxLineWidth = pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens;  // use the mean screen width since the text might be placed anywhere on the X screen.
 		pango_layout_set_width (pLayout, iMaxLineWidth * PANGO_SCALE);  // PANGO_WRAP_WORD by default
 	}
+	else
+		pango_layout_set_width (pLayout, -1);
 	PangoRectangle log;
 	pango_layout_get_pixel_extents (pLayout, NULL, &log);
 	
@@ -867,13 +978,120 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	*iTextWidth = *iTextWidth/** / fMaxScale*/;
 	*iTextHeight = *iTextHeight/** / fMaxScale*/;
 	
-	g_object_unref (pLayout);
 	pango_font_description_set_absolute_size (pDesc, iSize * PANGO_SCALE);
 	cairo_destroy (pSourceContext);
 	return pNewSurface;
 }
 
 
+// cache of the text surfaces, most recently used first.
+typedef struct {
+	gchar *cKey;
+	cairo_surface_t *pSurface;
+	int iWidth, iHeight;
+	gsize iSize;
+	GList link;
+	} CairoDockTextSurface;
+
+static GHashTable *s_pTextSurfaces = NULL;  // key -> CairoDockTextSurface
+static GQueue s_textSurfacesLRU = G_QUEUE_INIT;
+static gsize s_iTextSurfacesSize = 0;
+static int s_iTextSurfacesStyleStamp = 0;
+
+static void _free_text_surface (CairoDockTextSurface *pEntry)
+{
+	g_free (pEntry->cKey);
+	cairo_surface_destroy (pEntry->pSurface);
+	g_free (pEntry);
+}
+
+static void _remove_text_surface (CairoDockTextSurface *pEntry)
+{
+	g_queue_unlink (&s_textSurfacesLRU, &pEntry->link);
+	s_iTextSurfacesSize -= pEntry->iSize;
+	g_hash_table_remove (s_pTextSurfaces, pEntry->cKey);  // frees the entry
+}
+
+void cairo_dock_clear_text_surfaces_cache (void)
+{
+	if (s_pTextSurfaces != NULL)
+		g_hash_table_remove_all (s_pTextSurfaces);
+	g_queue_init (&s_textSurfacesLRU);
+	s_iTextSurfacesSize = 0;
+}
+
+static gchar *_make_text_surface_key (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	int iMaxLineWidth = (pTextDescription->fMaxRelativeWidth != 0 ? pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens : 0);
+	const GdkRGBA *c1 = &pTextDescription->fColorStart.rgba, *c2 = &pTextDescription->fBackgroundColor.rgba, *c3 = &pTextDescription->fLineColor.rgba;
+	return g_strdup_printf ("%s|%d|%d%d%d%d|%d|%d|%.4f|%d|%.3f,%.3f,%.3f,%.3f|%.3f,%.3f,%.3f,%.3f|%.3f,%.3f,%.3f,%.3f|%s",
+		pTextDescription->cFont ? pTextDescription->cFont : "",
+		pTextDescription->iSize,
+		pTextDescription->bNoDecorations, pTextDescription->bUseDefaultColors, pTextDescription->bOutlined, pTextDescription->bUseMarkup,
+		pTextDescription->iMargin,
+		iMaxLineWidth,
+		fMaxScale,
+		iMaxWidth,
+		c1->red, c1->green, c1->blue, c1->alpha,
+		c2->red, c2->green, c2->blue, c2->alpha,
+		c3->red, c3->green, c3->blue, c3->alpha,
+		cText);
+}
+
+cairo_surface_t *cairo_dock_get_text_surface (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight)
+{
+	g_return_val_if_fail (cText != NULL && pTextDescription != NULL, NULL);
+	
+	//\_________________ the default colors may have changed, in which case all the surfaces are outdated.
+	int iStyleStamp = gldi_style_colors_get_stamp ();
+	if (iStyleStamp != s_iTextSurfacesStyleStamp)
+	{
+		cairo_dock_clear_text_surfaces_cache ();
+		s_iTextSurfacesStyleStamp = iStyleStamp;
+	}
+	if (s_pTextSurfaces == NULL)
+		s_pTextSurfaces = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify)_free_text_surface);  // the key belongs to the entry.
+	
+	//\_________________ look for the text in the cache.
+	gchar *cKey = _make_text_surface_key (cText, pTextDescription, fMaxScale, iMaxWidth);
+	CairoDockTextSurface *pEntry = g_hash_table_lookup (s_pTextSurfaces, cKey);
+	if (pEntry != NULL)
+	{
+		g_free (cKey);
+		g_queue_unlink (&s_textSurfacesLRU, &pEntry->link);
+		g_queue_push_head_link (&s_textSurfacesLRU, &pEntry->link);
+		*iTextWidth = pEntry->iWidth;
+		*iTextHeight = pEntry->iHeight;
+		return cairo_surface_reference (pEntry->pSurface);
+	}
+	
+	//\_________________ not found, render it and remember it.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (cText, pTextDescription, fMaxScale, iMaxWidth, iTextWidth, iTextHeight);
+	if (pSurface == NULL)
+	{
+		g_free (cKey);
+		return NULL;
+	}
+	pEntry = g_new0 (CairoDockTextSurface, 1);
+	pEntry->cKey = cKey;
+	pEntry->pSurface = cairo_surface_reference (pSurface);
+	pEntry->iWidth = *iTextWidth;
+	pEntry->iHeight = *iTextHeight;
+	pEntry->iSize = (gsize)*iTextWidth * *iTextHeight * 4;  // roughly, the scale factor is ignored.
+	pEntry->link.data = pEntry;
+	g_hash_table_insert (s_pTextSurfaces, cKey, pEntry);
+	g_queue_push_head_link (&s_textSurfacesLRU, &pEntry->link);
+	s_iTextSurfacesSize += pEntry->iSize;
+	
+	//\_________________ forget the least recently used surfaces if the cache is full.
+	while (s_iTextSurfacesSize > CAIRO_DOCK_TEXT_SURFACES_CACHE_MAX_SIZE && s_textSurfacesLRU.length > 1)
+	{
+		_remove_text_surface (s_textSurfacesLRU.tail->data);
+	}
+	return pSurface;
+}
+
+
 cairo_surface_t * cairo_dock_duplicate_surface (cairo_surface_t *pSurface, double fWidth, double fHeight, double fDesiredWidth, double fDesiredHeight)
 {
 	g_return_val_if_fail (pSurface != NULL, NULL);
@@ -70,7 +70,7 @@ typedef enum {
 #define CAIRO_DOCK_ORIENTATION_MASK (7<<3)
 
 
-/** Create a surface from raw data of an X icon. The biggest icon possible is taken. The ratio is kept, and the surface will fill the space with transparency if necessary.
+/** Create a surface from raw data of an X icon. The smallest icon at least as big as the surface is taken, or the biggest one if they are all smaller. The ratio is kept, and the surface will fill the space with transparency if necessary.
 *@param pXIconBuffer raw data of the icon.
 *@param iBufferNbElements number of elements in the buffer.
 *@param iWidth will be filled with the resulting width of the surface.
@@ -123,6 +123,15 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 */
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight);
 
+/** Same as \ref cairo_dock_create_surface_from_image_simple, but it can be called from any thread: the image must be given by its path, and the result is a plain image surface, that is not tied to the screen.
+*@param cImagePath path of an image.
+*@param fImageWidth the desired surface width.
+*@param fImageHeight the desired surface height.
+*@param fDeviceScale scale factor of the screen the surface will be drawn on; it's the only scale used (also to look into the image cache), the screen is never queried.
+*@return the newly allocated image surface.
+*/
+cairo_surface_t *cairo_dock_create_image_surface_from_image_simple (const gchar *cImagePath, double fImageWidth, double fImageHeight, double fDeviceScale);
+
 /** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the icons themes known by Cairo-Dock. 
 *@param cImagePath path or name of an image.
 *@param fImageWidth the desired surface width.
@@ -177,6 +186,25 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 */
 #define cairo_dock_create_surface_from_text(cText, pLabelDescription, iTextWidthPtr, iTextHeightPtr) cairo_dock_create_surface_from_text_full (cText, pLabelDescription, 1., 0, iTextWidthPtr, iTextHeightPtr) 
 
+/// Maximum size of the text surfaces kept in memory by \ref cairo_dock_get_text_surface, in bytes.
+#define CAIRO_DOCK_TEXT_SURFACES_CACHE_MAX_SIZE (4 * 1024 * 1024)
+
+/** Same as \ref cairo_dock_create_surface_from_text_full, except that the surfaces are shared: a text that has already been rendered with the same description is not rendered again. The least recently used surfaces are forgotten when the cache is full, and all of them when the style changes.
+* The surface must not be modified, since it may be shared with other users; destroy it with cairo_surface_destroy when you don't need it anymore, as usual.
+*@param cText the text.
+*@param pLabelDescription description of the text rendering.
+*@param fMaxScale maximum zoom of the text.
+*@param iMaxWidth maximum authorized width for the surface; it will be zoomed in to fits this limit. 0 for no limit.
+*@param iTextWidth will be filled the width of the resulting surface.
+*@param iTextHeight will be filled the height of the resulting surface.
+*@return a new reference on the surface.
+*/
+cairo_surface_t *cairo_dock_get_text_surface (const gchar *cText, GldiTextDescription *pLabelDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight);
+
+/** Forget all the text surfaces rendered by \ref cairo_dock_get_text_surface.
+*/
+void cairo_dock_clear_text_surfaces_cache (void);
+
 /** Create a surface identical to another, possibly resizing it.
 *@param pSurface surface to duplicate.
 *@param fWidth the width of the surface.
@@ -21,189 +21,344 @@
 #include <stdlib.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-profiler.h"
 #include "cairo-dock-task.h"
 
-#ifndef GLIB_VERSION_2_32
-#define G_MUTEX_INIT(a)  a = g_mutex_new ()
-#define G_COND_INIT(a)   a = g_cond_new ()
-#define G_MUTEX_CLEAR(a) g_mutex_free (a)
-#define G_COND_CLEAR(a)  g_cond_free (a)
-#define G_THREAD_UNREF(t) g_free (t)
-#else
-#define G_MUTEX_INIT(a)  a = g_new (GMutex, 1); g_mutex_init (a)
-#define G_COND_INIT(a)   a = g_new (GCond, 1);  g_cond_init (a)
-#define G_MUTEX_CLEAR(a) g_mutex_clear (a); g_free (a)
-#define G_COND_CLEAR(a)  g_cond_clear (a);  g_free (a)
-#define G_THREAD_UNREF(t) if (t) g_thread_unref (t)
-#endif
-
-#define _schedule_next_iteration(pTask) do {\
-	if (pTask->iSidTimer == 0 && pTask->iPeriod)\
-		pTask->iSidTimer = g_timeout_add_seconds (pTask->iPeriod, (GSourceFunc) _launch_task_timer, pTask); } while (0)
-
-#define _cancel_next_iteration(pTask) do {\
-	if (pTask->iSidTimer != 0) {\
-		g_source_remove (pTask->iSidTimer);\
-		pTask->iSidTimer = 0; } } while (0)
+#define GLDI_TASK_DEFAULT_MAX_THREADS 8
+
+// state of the 'get_data' job of a Task.
+enum {
+	GLDI_TASK_JOB_IDLE = 0,
+	GLDI_TASK_JOB_QUEUED,  // waiting for a free thread in the pool
+	GLDI_TASK_JOB_RUNNING
+};
+
+static GThreadPool *s_pTaskPool = NULL;  // all the Tasks share this pool, instead of having 1 thread each.
+static gint s_iMaxThreads = GLDI_TASK_DEFAULT_MAX_THREADS;
+static GAsyncQueue *s_pFinishedJobs = NULL;  // Tasks whose 'get_data' is over, waiting for the main loop
+static gint s_bFinishedJobsIdle = 0;
 
 #define _set_elapsed_time(pTask) do {\
 	pTask->fElapsedTime = g_timer_elapsed (pTask->pClock, NULL);\
 	g_timer_start (pTask->pClock); } while (0)
 
-#define _free_task(pTask) do {\
+// the Task is not used anymore by its owner: free the user data now (the module that provides 'free_data' might be unloaded just after). The structure itself is freed once no job refers to it.
+#define _release_task(pTask) do {\
+	g_atomic_int_set (&pTask->bDiscard, 1);\
 	if (pTask->free_data)\
 		pTask->free_data (pTask->pSharedMemory);\
-	g_timer_destroy (pTask->pClock);\
-	G_MUTEX_CLEAR (pTask->pMutex);\
-	if (pTask->pCond) {\
-		G_COND_CLEAR (pTask->pCond); }\
-	G_THREAD_UNREF (pTask->pThread);\
-	g_free (pTask); } while (0)
-
-static gboolean _launch_task_timer (GldiTask *pTask)
+	pTask->free_data = NULL;\
+	pTask->pSharedMemory = NULL;\
+	_unref_task (pTask); } while (0)
+
+#define GLDI_TASK_NB_UNCHANGED_ITERATIONS 3  // in adaptive mode, number of iterations without change before the frequency is downgraded.
+static const gint s_iFrequencyFactor[GLDI_TASK_NB_FREQUENCIES] = {1, 2, 4, 10};  // the period is multiplied by these factors in each frequency state.
+#define _get_current_period(pTask) ((pTask)->iPeriod * s_iFrequencyFactor[(pTask)->iFrequencyState])
+
+static GList *s_pScheduledTasks = NULL;  // periodic Tasks waiting for their next iteration
+static guint s_iSidScheduler = 0;  // the only timer used by all the periodic Tasks
+static gint64 s_iSchedulerWakeUp = 0;  // when this timer will fire
+
+static void _unref_task (GldiTask *pTask)
 {
-	gldi_task_launch (pTask);
-	return TRUE;
+	pTask->iRef --;
+	if (pTask->iRef > 0)
+		return;
+	g_timer_destroy (pTask->pClock);
+	g_mutex_clear (pTask->pMutex);
+	g_free (pTask->pMutex);
+	g_cond_clear (pTask->pCond);
+	g_free (pTask->pCond);
+	g_free (pTask);
+}
+
+static void _launch_iteration (GldiTask *pTask);
+
+  /////////////////
+ /// SCHEDULER ///
+/////////////////
+
+// iterations are aligned on multiples of their period, so that Tasks with related periods (1s, 2s, 5s, 10s...) run at the same instants.
+static gint64 _get_aligned_time (gint64 iNow, gint iPeriod)
+{
+	gint64 p = (gint64)iPeriod * G_USEC_PER_SEC;
+	gint64 t = (iNow / p + 1) * p;
+	if (t - iNow < p / 2)  // don't shorten the first interval too much
+		t += p;
+	return t;
 }
-static gboolean _check_for_update_idle (GldiTask *pTask)
+
+static gboolean _on_scheduler_tick (gpointer data);
+static void _arm_scheduler (void)
 {
-	// process the data (we don't need to wait that the thread is over, so do it now, it will let more time for the thread to finish, and therfore often save a 'usleep').
-	if (pTask->bNeedsUpdate)  // data are ready to be processed -> perform the update
+	if (s_pScheduledTasks == NULL)
 	{
-		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
+		if (s_iSidScheduler != 0)
 		{
-			pTask->bContinue = pTask->update (pTask->pSharedMemory);
+			g_source_remove (s_iSidScheduler);
+			s_iSidScheduler = 0;
 		}
-		pTask->bNeedsUpdate = FALSE;  // now update is done, we won't do it any more until the next iteration, even is we loop on this function.
+		return;
 	}
+	gint64 iNext = G_MAXINT64;
+	GList *t;
+	for (t = s_pScheduledTasks; t != NULL; t = t->next)
+		iNext = MIN (iNext, ((GldiTask*)t->data)->iNextIteration);
+	if (s_iSidScheduler != 0)
+	{
+		if (s_iSchedulerWakeUp <= iNext)  // we'll wake up in time
+			return;
+		g_source_remove (s_iSidScheduler);
+	}
+	
+	gint64 iNow = g_get_monotonic_time ();
+	gint64 iDelay = MAX (0, iNext - iNow);
+	if (iDelay >= G_USEC_PER_SEC)  // a timer in seconds is grouped with the other ones of the session, to save wake-ups; it can fire a bit early, this is handled by the slack of the Tasks.
+		s_iSidScheduler = g_timeout_add_seconds (iDelay / G_USEC_PER_SEC, (GSourceFunc) _on_scheduler_tick, NULL);
+	else
+		s_iSidScheduler = g_timeout_add (iDelay / 1000, (GSourceFunc) _on_scheduler_tick, NULL);
+	s_iSchedulerWakeUp = iNow + iDelay;
+}
+
+static gboolean _on_scheduler_tick (G_GNUC_UNUSED gpointer data)
+{
+	s_iSidScheduler = 0;
+	gint64 iNow = g_get_monotonic_time ();
 	
-	// finish the iteration, and possibly schedule the next one (the thread must be finished for this part).
-	if (g_mutex_trylock (pTask->pMutex))  // if the thread is over
+	// collect the Tasks that are due, or almost: a Task can run a bit early to share this wake-up.
+	GList *pDueTasks = NULL, *t;
+	GldiTask *pTask;
+	gint64 iPeriod, iSlack;
+	for (t = s_pScheduledTasks; t != NULL; t = t->next)
 	{
-		if (pTask->bDiscard)  // if the task has been discarded, it's the end of the journey for it.
-		{
-			if (pTask->pCond)
-			{
-				pTask->bRunThread = TRUE;
-				g_cond_signal (pTask->pCond);
-				g_mutex_unlock (pTask->pMutex);
-				g_thread_join (pTask->pThread); // unref the thread
-			}
-			else
-			{
-				g_mutex_unlock (pTask->pMutex);
-				G_THREAD_UNREF (pTask->pThread);
-			}
-			pTask->pThread = NULL;
-			_free_task (pTask);
-			return FALSE;
-		}
-		
-		if (! pTask->pCond)  // one-shot thread => the thread is over
+		pTask = t->data;
+		iPeriod = (gint64)_get_current_period (pTask) * G_USEC_PER_SEC;
+		iSlack = MIN (iPeriod / 4, G_USEC_PER_SEC);
+		if (pTask->iNextIteration <= iNow + iSlack)
 		{
-			G_THREAD_UNREF (pTask->pThread);
-			pTask->pThread = NULL;
+			pTask->iNextIteration += iPeriod;  // stay on the grid
+			if (pTask->iNextIteration <= iNow)  // we're late (suspend, busy main loop) -> realign from now
+				pTask->iNextIteration = _get_aligned_time (iNow, _get_current_period (pTask));
+			pTask->iRef ++;  // a Task can be destroyed by the update of another one
+			pDueTasks = g_list_prepend (pDueTasks, pTask);
 		}
-		
-		pTask->iSidUpdateIdle = 0;  // set it before the unlock, as it is accessed in the thread part
+	}
+	
+	// and run them all.
+	for (t = pDueTasks; t != NULL; t = t->next)
+	{
+		pTask = t->data;
+		if (! pTask->bDiscard && pTask->iNextIteration != 0)  // not stopped or discarded in the meantime
+			_launch_iteration (pTask);
+		_unref_task (pTask);
+	}
+	g_list_free (pDueTasks);
+	
+	_arm_scheduler ();
+	return FALSE;
+}
+
+static void _schedule_next_iteration (GldiTask *pTask)
+{
+	if (pTask->iNextIteration == 0 && pTask->iPeriod)
+	{
+		pTask->iNextIteration = _get_aligned_time (g_get_monotonic_time (), _get_current_period (pTask));
+		s_pScheduledTasks = g_list_prepend (s_pScheduledTasks, pTask);
+		_arm_scheduler ();
+	}
+}
+
+static void _cancel_next_iteration (GldiTask *pTask)
+{
+	if (pTask->iSidTimer != 0)  // delayed launch
+	{
+		g_source_remove (pTask->iSidTimer);
+		pTask->iSidTimer = 0;
+	}
+	if (pTask->iNextIteration != 0)
+	{
+		s_pScheduledTasks = g_list_remove (s_pScheduledTasks, pTask);
+		pTask->iNextIteration = 0;  // the scheduler's timer will just re-arm itself if it fires for nothing
+	}
+}
+
+// the data of an adaptive Task are considered as changed, unless its update tells the contrary.
+static void _adapt_frequency (GldiTask *pTask)
+{
+	if (! pTask->bAdaptiveFrequency)
+		return;
+	if (pTask->bDataChanged)
+	{
+		pTask->iNbUnchangedIterations = 0;
+		gldi_task_set_normal_frequency (pTask);
+	}
+	else if (++ pTask->iNbUnchangedIterations >= GLDI_TASK_NB_UNCHANGED_ITERATIONS)
+	{
+		pTask->iNbUnchangedIterations = 0;
+		gldi_task_downgrade_frequency (pTask);
+	}
+}
+
+#define _call_update(pTask) do {\
+	pTask->bDataChanged = TRUE;\
+	if (G_UNLIKELY (g_bProfilerEnabled)) {\
+		gint64 iStartTime = g_get_monotonic_time ();\
+		pTask->bContinue = pTask->update (pTask->pSharedMemory);\
+		gldi_profiler_record_function (GLDI_PROFILER_TASK_UPDATE, NULL, (gpointer)pTask->update, g_get_monotonic_time () - iStartTime); }\
+	else\
+		pTask->bContinue = pTask->update (pTask->pSharedMemory); } while (0)
+
+
+  ////////////
+ /// TASK ///
+////////////
+
+static void _finish_iteration (GldiTask *pTask)
+{
+	g_mutex_lock (pTask->pMutex);
+	gboolean bNeedsUpdate = pTask->bNeedsUpdate;
+	pTask->bNeedsUpdate = FALSE;
+	g_mutex_unlock (pTask->pMutex);
+	if (! bNeedsUpdate)  // the Task has been stopped in the meantime, or this is a skipped job.
+		return;
+	
+	// process the data.
+	if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
+	{
+		_call_update (pTask);
+	}
+	
+	if (pTask->bDiscard)  // if the task has been discarded (before or during the update), it's the end of the journey for it.
+	{
+		pTask->bIsRunning = FALSE;
+		_release_task (pTask);
+		return;
+	}
+	
+	// schedule the next iteration if necessary.
+	if (! pTask->bContinue)
+	{
+		_cancel_next_iteration (pTask);
+	}
+	else
+	{
+		_adapt_frequency (pTask);
+		_schedule_next_iteration (pTask);
+	}
+	pTask->bIsRunning = FALSE;
+}
+
+static gboolean _on_jobs_finished_idle (G_GNUC_UNUSED gpointer data)
+{
+	g_atomic_int_set (&s_bFinishedJobsIdle, 0);  // reset it before emptying the queue, so that no job can be forgotten
+	GldiTask *pTask;
+	while ((pTask = g_async_queue_try_pop (s_pFinishedJobs)) != NULL)
+	{
+		_finish_iteration (pTask);
+		_unref_task (pTask);  // the ref of the job
+	}
+	return FALSE;
+}
+
+static void _run_get_data (GldiTask *pTask, G_GNUC_UNUSED gpointer data)
+{
+	g_mutex_lock (pTask->pMutex);
+	if (pTask->iJobState == GLDI_TASK_JOB_QUEUED)  // else the Task has been stopped before we could run it.
+	{
+		pTask->iJobState = GLDI_TASK_JOB_RUNNING;
 		g_mutex_unlock (pTask->pMutex);
 		
-		// schedule the next iteration if necessary.
-		if (! pTask->bContinue)
+		//\_______________________ get the data
+		_set_elapsed_time (pTask);
+		if (G_UNLIKELY (g_bProfilerEnabled))
 		{
-			_cancel_next_iteration (pTask);
+			gint64 iStartTime = g_get_monotonic_time ();
+			pTask->get_data (pTask->pSharedMemory);
+			gldi_profiler_record_function (GLDI_PROFILER_TASK_GET_DATA, NULL, (gpointer)pTask->get_data, g_get_monotonic_time () - iStartTime);
 		}
 		else
-		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-			_schedule_next_iteration (pTask);
-		}
-		pTask->bIsRunning = FALSE;
-		return FALSE;  // the update is now finished, quit.
+			pTask->get_data (pTask->pSharedMemory);
+		
+		// and signal that data are ready to be processed.
+		g_mutex_lock (pTask->pMutex);
+		pTask->bNeedsUpdate = TRUE;
+		pTask->iJobState = GLDI_TASK_JOB_IDLE;
+		g_cond_broadcast (pTask->pCond);  // in case 'gldi_task_stop' is waiting for us
 	}
+	g_mutex_unlock (pTask->pMutex);
 	
-	// if the thread is not yet over, come back in 1ms.
-	g_usleep (1);  // we don't want to block the main loop until the thread is over; so just sleep 1ms to give it a chance to terminate. so it's a kind of 'sched_yield()' wihout blocking the main loop.
-	return TRUE;
+	//\_______________________ call the update function from the main loop; a single wake-up handles all the jobs that finished meanwhile.
+	g_async_queue_push (s_pFinishedJobs, pTask);
+	if (g_atomic_int_compare_and_exchange (&s_bFinishedJobsIdle, 0, 1))
+		g_idle_add ((GSourceFunc) _on_jobs_finished_idle, NULL);
 }
-static gpointer _get_data_threaded (GldiTask *pTask)
+
+static gboolean _push_job (GldiTask *pTask)
 {
+	if (s_pTaskPool == NULL)
+	{
+		s_pFinishedJobs = g_async_queue_new ();
+		s_pTaskPool = g_thread_pool_new ((GFunc) _run_get_data, NULL, s_iMaxThreads, FALSE, NULL);  // not exclusive: threads are created on demand and end when they stay idle.
+	}
 	g_mutex_lock (pTask->pMutex);
-	_run_thread:  // at this point the mutex is locked, either by the first execution of this function, or by 'g_cond_wait'
-	
-	//\_______________________ get the data
-	_set_elapsed_time (pTask);
-	pTask->get_data (pTask->pSharedMemory);
-	
-	// and signal that data are ready to be processed.
-	pTask->bNeedsUpdate = TRUE;  // this is only accessed by the update fonction, which is triggered just after, so no need to protect this variable.
-	
-	//\_______________________ call the update function from the main loop
-	if (pTask->iSidUpdateIdle == 0)
-		pTask->iSidUpdateIdle = g_idle_add ((GSourceFunc) _check_for_update_idle, pTask);  // note that 'iSidUpdateIdle' can actually be set after the 'update' is called. that's why the 'update' have to wait for the mutex to finish its job.
+	pTask->iJobState = GLDI_TASK_JOB_QUEUED;
+	g_mutex_unlock (pTask->pMutex);
+	pTask->iRef ++;  // released when the job comes back in the main loop
 	
-	// sleep until the next iteration or just leave.
-	if (pTask->pCond)  // periodic task -> block until the condition becomes TRUE again.
+	GError *erreur = NULL;
+	g_thread_pool_push (s_pTaskPool, pTask, &erreur);
+	if (erreur != NULL)  // couldn't launch the job.
 	{
-		pTask->bRunThread = FALSE;
-		while (! pTask->bRunThread)
-			g_cond_wait (pTask->pCond, pTask->pMutex);  // releases the mutex, then takes it again when awakening.
-		if (g_atomic_int_get (&pTask->bDiscard) == 0)
-			goto _run_thread;
+		cd_warning (erreur->message);
+		g_error_free (erreur);
+		pTask->iJobState = GLDI_TASK_JOB_IDLE;
+		pTask->iRef --;
+		return FALSE;
 	}
-	g_mutex_unlock (pTask->pMutex);
-	g_thread_exit (NULL);
-	return NULL;
+	return TRUE;
 }
-void gldi_task_launch (GldiTask *pTask)
+
+static void _launch_iteration (GldiTask *pTask)
 {
-	g_return_if_fail (pTask != NULL);
 	if (pTask->get_data == NULL)  // no asynchronous work -> just call the 'update' and directly schedule the next iteration
 	{
 		_set_elapsed_time (pTask);
-		pTask->bContinue = pTask->update (pTask->pSharedMemory);
+		_call_update (pTask);
 		if (! pTask->bContinue)
 		{
 			_cancel_next_iteration (pTask);
 		}
 		else
 		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
+			_adapt_frequency (pTask);
 			_schedule_next_iteration (pTask);
 		}
 	}
-	else  // launch the asynchronous work in a thread
+	else  // launch the asynchronous work in the pool
 	{
-		if (pTask->pThread == NULL)  // no thread yet -> create and launch it
+		if (! pTask->bIsRunning)  // not already queued, running or waiting for its update
 		{
 			pTask->bIsRunning = TRUE;
-			GError *erreur = NULL;
-			#ifndef GLIB_VERSION_2_32
-			pTask->pThread = g_thread_create ((GThreadFunc) _get_data_threaded, pTask, TRUE, &erreur);  // TRUE <=> joinable
-			#else
-			pTask->pThread = g_thread_try_new ("Cairo-Dock Task", (GThreadFunc) _get_data_threaded, pTask, &erreur);
-			#endif
-			if (erreur != NULL)  // on n'a pas pu lancer le thread.
-			{
-				cd_warning (erreur->message);
-				g_error_free (erreur);
+			if (! _push_job (pTask))
 				pTask->bIsRunning = FALSE;
-			}
-		}
-		else  // thread already exists; it's either running or sleeping or finished with a pending update
-		if (pTask->pCond && g_mutex_trylock (pTask->pMutex))  // it's a periodic thread, and it's not currently running...
-		{
-			if (pTask->iSidUpdateIdle == 0)  // ...and it doesn't have a pending update -> awake it and run it again.
-			{
-				pTask->bRunThread = TRUE;
-				pTask->bIsRunning = TRUE;
-				g_cond_signal (pTask->pCond);
-			}
-			g_mutex_unlock (pTask->pMutex);
-		}  // else it's a one-shot thread or it's currently running or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
+		}  // else skip this iteration.
 	}
 }
 
+void gldi_task_launch (GldiTask *pTask)
+{
+	g_return_if_fail (pTask != NULL);
+	gldi_task_set_normal_frequency (pTask);
+	_launch_iteration (pTask);
+}
+
+void gldi_task_set_max_threads (gint iMaxThreads)
+{
+	s_iMaxThreads = (iMaxThreads > 0 ? iMaxThreads : GLDI_TASK_DEFAULT_MAX_THREADS);
+	if (s_pTaskPool != NULL)
+		g_thread_pool_set_max_threads (s_pTaskPool, s_iMaxThreads, NULL);
+}
+
 
 static gboolean _one_shot_timer (GldiTask *pTask)
 {
@@ -230,11 +385,11 @@ GldiTask *gldi_task_new_full (int iPeriod, GldiGetDataAsyncFunc get_data, GldiUp
 	pTask->free_data = free_data;
 	pTask->pSharedMemory = pSharedMemory;
 	pTask->pClock = g_timer_new ();
-	G_MUTEX_INIT (pTask->pMutex);
-	if (iPeriod != 0)
-	{
-		G_COND_INIT (pTask->pCond);
-	}
+	pTask->pMutex = g_new (GMutex, 1);
+	g_mutex_init (pTask->pMutex);
+	pTask->pCond = g_new (GCond, 1);
+	g_cond_init (pTask->pCond);
+	pTask->iRef = 1;
 	return pTask;
 }
 
@@ -248,41 +403,19 @@ void gldi_task_stop (GldiTask *pTask)
 	
 	if (gldi_task_is_running (pTask))
 	{
-		if (pTask->pThread)
+		if (pTask->get_data)
 		{
 			g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
-			if (pTask->pCond)  // the thread might be sleeping, awake it.
-			{
-				if (g_mutex_trylock (pTask->pMutex))
-				{
-					pTask->bRunThread = TRUE;
-					g_cond_signal (pTask->pCond);
-					g_mutex_unlock (pTask->pMutex);
-				}
-			}
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
-		if (pTask->iSidUpdateIdle != 0)  // do it after the thread has possibly scheduled the 'update'
-		{
-			g_source_remove (pTask->iSidUpdateIdle);
-			pTask->iSidUpdateIdle = 0;
-		}
-		pTask->bIsRunning = FALSE;  // since we didn't go through the 'update'
-	}
-	else
-	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit.
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
+			g_mutex_lock (pTask->pMutex);
+			if (pTask->iJobState == GLDI_TASK_JOB_QUEUED)  // not started yet -> it will be skipped
+				pTask->iJobState = GLDI_TASK_JOB_IDLE;
+			while (pTask->iJobState == GLDI_TASK_JOB_RUNNING)  // wait for the 'get_data' to finish
+				g_cond_wait (pTask->pCond, pTask->pMutex);
+			pTask->bNeedsUpdate = FALSE;  // skip the update
 			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
 			g_atomic_int_set (&pTask->bDiscard, 0);
 		}
+		pTask->bIsRunning = FALSE;  // since we didn't go through the 'update'
 	}
 }
 
@@ -302,15 +435,7 @@ void gldi_task_discard (GldiTask *pTask)
 	//   if we're inside the 'update' user callback, the task will be destroyed in the 2nd stage of the function (the user callback is called in the 1st stage).
 	if (! gldi_task_is_running (pTask))  // we can free the task immediately.
 	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit before we can free everything
-		{
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
-			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-		}
-		_free_task (pTask);
+		_release_task (pTask);
 	}
 }
 
@@ -320,12 +445,12 @@ void gldi_task_free (GldiTask *pTask)
 		return ;
 	
 	gldi_task_stop (pTask);
-	_free_task (pTask);
+	_release_task (pTask);
 }
 
 gboolean gldi_task_is_active (GldiTask *pTask)
 {
-	return (pTask != NULL && pTask->iSidTimer != 0);
+	return (pTask != NULL && (pTask->iNextIteration != 0 || pTask->iSidTimer != 0));
 }
 
 gboolean gldi_task_is_running (GldiTask *pTask)
@@ -333,21 +458,22 @@ gboolean gldi_task_is_running (GldiTask *pTask)
 	return (pTask != NULL && pTask->bIsRunning);
 }
 
-static void _restart_timer_with_frequency (GldiTask *pTask, int iNewPeriod)
+static void _restart_timer_with_frequency (GldiTask *pTask)
 {
-	gboolean bNeedsRestart = (pTask->iSidTimer != 0);
-	_cancel_next_iteration (pTask);
-	
-	if (bNeedsRestart && iNewPeriod != 0)
-		pTask->iSidTimer = g_timeout_add_seconds (iNewPeriod, (GSourceFunc) _launch_task_timer, pTask);
+	if (pTask->iNextIteration != 0)  // re-schedule the next iteration according to the new period
+	{
+		_cancel_next_iteration (pTask);
+		_schedule_next_iteration (pTask);
+	}
 }
 
 void gldi_task_change_frequency (GldiTask *pTask, int iNewPeriod)
 {
 	g_return_if_fail (pTask != NULL && pTask->iPeriod != 0 && iNewPeriod != 0);
 	pTask->iPeriod = iNewPeriod;
+	pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
 	
-	_restart_timer_with_frequency (pTask, iNewPeriod);
+	_restart_timer_with_frequency (pTask);
 }
 
 void gldi_task_change_frequency_and_relaunch (GldiTask *pTask, int iNewPeriod)
@@ -363,25 +489,8 @@ void gldi_task_downgrade_frequency (GldiTask *pTask)
 	if (pTask->iFrequencyState < GLDI_TASK_FREQUENCY_SLEEP)
 	{
 		pTask->iFrequencyState ++;
-		int iNewPeriod;
-		switch (pTask->iFrequencyState)
-		{
-			case GLDI_TASK_FREQUENCY_LOW :
-				iNewPeriod = 2 * pTask->iPeriod;
-			break ;
-			case GLDI_TASK_FREQUENCY_VERY_LOW :
-				iNewPeriod = 4 * pTask->iPeriod;
-			break ;
-			case GLDI_TASK_FREQUENCY_SLEEP :
-				iNewPeriod = 10 * pTask->iPeriod;
-			break ;
-			default :  // ne doit pas arriver.
-				iNewPeriod = pTask->iPeriod;
-			break ;
-		}
-		
 		cd_message ("degradation de la mesure (etat <- %d/%d)", pTask->iFrequencyState, GLDI_TASK_NB_FREQUENCIES-1);
-		_restart_timer_with_frequency (pTask, iNewPeriod);
+		_restart_timer_with_frequency (pTask);
 	}
 }
 
@@ -390,6 +499,21 @@ void gldi_task_set_normal_frequency (GldiTask *pTask)
 	if (pTask->iFrequencyState != GLDI_TASK_FREQUENCY_NORMAL)
 	{
 		pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-		_restart_timer_with_frequency (pTask, pTask->iPeriod);
+		_restart_timer_with_frequency (pTask);
 	}
 }
+
+void gldi_task_set_adaptive_frequency (GldiTask *pTask, gboolean bAdaptive)
+{
+	g_return_if_fail (pTask != NULL);
+	pTask->bAdaptiveFrequency = bAdaptive;
+	pTask->iNbUnchangedIterations = 0;
+	if (! bAdaptive)
+		gldi_task_set_normal_frequency (pTask);
+}
+
+void gldi_task_report_data_changed (GldiTask *pTask, gboolean bChanged)
+{
+	g_return_if_fail (pTask != NULL);
+	pTask->bDataChanged = bChanged;
+}
@@ -37,6 +37,10 @@ G_BEGIN_DECLS
  *
  * A Task can be periodic if you specify a period, otherwise it will be executed once. It also can also be fully synchronous if you don't specify an asynchronous function.
  * 
+ * The asynchronous phases of all the Tasks are executed by a shared pool of threads, whose size can be limited with \ref gldi_task_set_max_threads.
+ * 
+ * The periodic Tasks are driven by a single timer: their iterations are aligned on multiples of their period, and the Tasks that are due at about the same time run during the same wake-up. A Task can also adapt its frequency automatically to the rate at which its data change, see \ref gldi_task_set_adaptive_frequency.
+ * 
  */
 
 // Type of frequency for a periodic task. The frequency of the Task is divided by 2, 4, and 10 for each state.
@@ -55,8 +59,10 @@ typedef gboolean (* GldiUpdateSyncFunc ) (gpointer pSharedMemory);
 
 /// Definition of a periodic and/or asynchronous Task.
 struct _GldiTask {
-	// ID of the timer of the Task (if periodic)
+	// ID of the timer of a delayed launch
 	gint iSidTimer;
+	// time of the next iteration (monotonic time, in microseconds), 0 if the Task is not scheduled.
+	gint64 iNextIteration;
 	// TRUE if the thread is running or about to run or if the update is pending
 	gboolean bIsRunning;
 	// function carrying out the heavy job.
@@ -67,6 +73,12 @@ struct _GldiTask {
 	guint iPeriod;
 	// state of the frequency of the Task.
 	GldiTaskFrequencyState iFrequencyState;
+	// TRUE if the frequency follows the changes of the data.
+	gboolean bAdaptiveFrequency;
+	// number of consecutive iterations without change of the data, in adaptive mode.
+	gint iNbUnchangedIterations;
+	// whether the last update changed something, in adaptive mode.
+	gboolean bDataChanged;
 	// timer to get the accurate amount of time since last update.
 	GTimer *pClock;
 	// time elapsed since last update.
@@ -76,16 +88,14 @@ struct _GldiTask {
 	// below are the parameters accessed inside the thread => only between mutex lock/unlock
 	/// structure passed as parameter of the 'get_data' and 'update' functions. Must not be accessed outside of these 2 functions !
 	gpointer pSharedMemory;
-	// ID of the idle source to perform the update.
-	gint iSidUpdateIdle;
 	/// TRUE when the task has been discarded.
 	gboolean bDiscard;
 	gboolean bNeedsUpdate;  // TRUE when new data are waiting to be processed.
 	gboolean bContinue;  // result of the 'update' function (TRUE -> continue, FALSE -> stop, if the task is periodic).
-	GThread *pThread;  // the thread that execute the asynchronous 'get_data' callback
-	GCond *pCond;  // condition to awake the thread (if periodic).
-	gboolean bRunThread;  // condition value: whether to run the thread or exit.
-	GMutex *pMutex;  // mutex associated with the condition.
+	gint iJobState;  // whether the 'get_data' job is idle, queued in the pool of threads, or running.
+	GCond *pCond;  // signaled when the 'get_data' job is over.
+	GMutex *pMutex;  // mutex associated with the condition, protects the state of the job.
+	gint iRef;  // the Task is freed when neither its owner nor a job refer to it anymore.
 } ;
 
 
@@ -166,6 +176,22 @@ void gldi_task_downgrade_frequency (GldiTask *pTask);
 */
 void gldi_task_set_normal_frequency (GldiTask *pTask);
 
+/** Let the frequency of a Task follow the changes of its data: after a few iterations without change, the frequency is downgraded step by step, and it returns to its normal state as soon as the data change again. The 'update' function reports whether something changed with \ref gldi_task_report_data_changed.
+*@param pTask the periodic Task.
+*@param bAdaptive TRUE to enable the adaptive frequency, FALSE to disable it (the frequency returns to its normal state).
+*/
+void gldi_task_set_adaptive_frequency (GldiTask *pTask, gboolean bAdaptive);
+/** Tell whether the current iteration of a Task changed something. It is meant to be called from the 'update' function; if it is not called, the data are considered as changed. It is only useful if the Task has an adaptive frequency.
+*@param pTask the periodic Task.
+*@param bChanged FALSE if the data are the same as in the previous iteration.
+*/
+void gldi_task_report_data_changed (GldiTask *pTask, gboolean bChanged);
+
+/** Limit the number of threads used to run the asynchronous phase of the Tasks. If more Tasks need to run at the same time, they wait for a thread to be available.
+*@param iMaxThreads maximum number of threads, or 0 to use the default limit.
+*/
+void gldi_task_set_max_threads (gint iMaxThreads);
+
 /** Get the time elapsed since the last time the Task has run.
 *@param pTask the periodic Task.
 */
@@ -136,6 +136,7 @@ gboolean cairo_dock_current_theme_need_save (void)
 
 void cairo_dock_delete_conf_file (const gchar *cConfFilePath)
 {
+	cairo_dock_sync_keyfile (cConfFilePath);  // so that no pending change re-creates it later.
 	g_remove (cConfFilePath);
 	cairo_dock_mark_current_theme_as_modified (TRUE);
 }
@@ -177,6 +178,7 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 	gchar *cNewThemeNameEscaped = g_strescape (cNewThemeNameWithoutSlashes, NULL);
 
 	cd_message ("we save in %s", cNewThemeNameWithoutSlashes);
+	cairo_dock_sync_all_keyfiles ();  // the files are copied as they are on the disk.
 	GString *sCommand = g_string_new ("");
 	gboolean bThemeSaved = FALSE;
 	int r;
@@ -305,6 +307,7 @@ gboolean cairo_dock_package_current_theme (const gchar *cThemeName, const gchar
 	cairo_dock_extract_package_type_from_name (cNewThemeName);
 	
 	cd_message ("building theme package ...");
+	cairo_dock_sync_all_keyfiles ();
 	const gchar *cPackageBuilderPath = GLDI_SHARE_DATA_DIR"/scripts/cairo-dock-package-theme.sh";
 	gboolean bScriptFound = g_file_test (cPackageBuilderPath, G_FILE_TEST_EXISTS);
 	if (bScriptFound)
@@ -457,6 +460,7 @@ static gboolean _cairo_dock_import_local_theme (const gchar *cNewThemePath, gboo
 	//\___________________ We load global behaviour parameters for each dock.
 	GString *sCommand = g_string_new ("");
 	cd_message ("Applying changes ...");
+	cairo_dock_sync_all_keyfiles ();  // write the pending changes now, rather than over the files of the new theme.
 	if (g_pMainDock == NULL || bLoadBehavior)
 	{
 		g_string_printf (sCommand, "rm -f \"%s\"/*.conf", g_cCurrentThemePath);
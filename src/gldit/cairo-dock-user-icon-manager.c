@@ -28,6 +28,7 @@
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-stack-icon-manager.h"
 #include "cairo-dock-separator-manager.h"
+#include "cairo-dock-class-manager.h"  // cairo_dock_prefetch_class_desktop_file
 #define _MANAGER_DEF_
 #include "cairo-dock-user-icon-manager.h"
 
@@ -149,40 +150,128 @@ static void _load_one_icon (gpointer pAttr, gpointer)
 	g_free ((void*)attr->cConfFileName);
 }
 
+// a launcher file parsed by a worker thread; the icon itself is built in the main thread.
+typedef struct {
+	gchar *cConfFileName;
+	GldiUserIconAttr *attr;  // NULL if the file couldn't be read
+	gchar *cOriginPath;  // path of the application's .desktop file, if the launcher points to one
+	GKeyFile *pOriginKeyFile;  // its content
+	GAsyncQueue *pResults;
+	gboolean bParsed;  // TRUE once the job has been run
+	} GldiUserIconJob;
+
+static void _parse_one_conf_file (GldiUserIconJob *pJob, gpointer)
+{
+	GldiUserIconAttr *attr = g_new0 (GldiUserIconAttr, 1);
+	if (_user_icon_conf_open (pJob->cConfFileName, attr))
+	{
+		pJob->attr = attr;
+		// a launcher will register its class; parse the application's .desktop file as well, so that it doesn't have to be done in the main thread (only if we know its path, the search in the desktop files database is not thread-safe).
+		if (attr->iType == GLDI_USER_ICON_TYPE_LAUNCHER)
+		{
+			gchar **pOrigins = g_key_file_get_string_list (attr->pKeyFile, "Desktop Entry", "Origin", NULL, NULL);
+			if (pOrigins != NULL && pOrigins[0] != NULL && *pOrigins[0] == '/')
+			{
+				pJob->pOriginKeyFile = cairo_dock_open_key_file (pOrigins[0]);
+				if (pJob->pOriginKeyFile != NULL)
+					pJob->cOriginPath = g_strdup (pOrigins[0]);
+			}
+			g_strfreev (pOrigins);
+		}
+	}
+	else g_free (attr);
+	pJob->bParsed = TRUE;
+	g_async_queue_push (pJob->pResults, pJob);
+}
+
 void gldi_user_icons_new_from_directory (const gchar *cDirectory)
 {
 	cd_message ("%s (%s)", __func__, cDirectory);
 	GDir *dir = g_dir_open (cDirectory, 0, NULL);
 	g_return_if_fail (dir != NULL);
 	
+	//\__________________ parse all the conf files in parallel.
+	GAsyncQueue *pResults = g_async_queue_new ();
+	GThreadPool *pPool = g_thread_pool_new ((GFunc)_parse_one_conf_file, NULL, MAX (1, (gint)g_get_num_processors ()), FALSE, NULL);
+	GPtrArray *pJobs = g_ptr_array_new ();
 	const gchar *cFileName;
-	GPtrArray *array = g_ptr_array_new_full (10, g_free);
-
+	guint i;
+	GldiUserIconJob *pJob;
+	GError *erreur = NULL;
+	gboolean bPoolFailed = FALSE;
 	while ((cFileName = g_dir_read_name (dir)) != NULL)
 	{
 		if (g_str_has_suffix (cFileName, ".desktop"))
 		{
-			GldiUserIconAttr *attr = g_new0 (GldiUserIconAttr, 1);
-			gboolean bRead = _user_icon_conf_open (cFileName, attr);
-			if (bRead)
+			pJob = g_new0 (GldiUserIconJob, 1);
+			pJob->cConfFileName = g_strdup (cFileName);
+			pJob->pResults = pResults;
+			g_ptr_array_add (pJobs, pJob);
+			if (pPool != NULL && ! bPoolFailed)
 			{
-				if (attr->iType == GLDI_USER_ICON_TYPE_STACK)
+				if (! g_thread_pool_push (pPool, pJob, &erreur))  // the job is queued anyway, but there may be no thread to run it.
 				{
-					// this is a subdock, create it now
-					_load_one_icon (attr, NULL);
-					g_free (attr);
+					cd_warning ("couldn't start a thread to parse the launchers: %s", erreur->message);
+					g_error_free (erreur);
+					erreur = NULL;
+					bPoolFailed = TRUE;
 				}
-				// this is a launcher or separator, save it for later, after all subdocks have been created
-				else g_ptr_array_add (array, attr);
 			}
-			else g_free (attr);
+			else  // no thread available, parse it here.
+				_parse_one_conf_file (pJob, NULL);
 		}
 	}
 	g_dir_close (dir);
 	
+	//\__________________ wait for all the files to be parsed; the results are then used in the order of the directory, so that the loading doesn't depend on the threads.
+	if (bPoolFailed)  // stop the pool once the running jobs are done, and parse here the files it didn't handle.
+	{
+		g_thread_pool_free (pPool, TRUE, TRUE);
+		for (i = 0; i < pJobs->len; i ++)
+		{
+			pJob = g_ptr_array_index (pJobs, i);
+			if (! pJob->bParsed)
+				_parse_one_conf_file (pJob, NULL);
+		}
+	}
+	else
+	{
+		for (i = 0; i < pJobs->len; i ++)
+			g_async_queue_pop (pResults);
+		if (pPool != NULL)
+			g_thread_pool_free (pPool, FALSE, TRUE);
+	}
+	g_async_queue_unref (pResults);
+	
+	//\__________________ create the icons in the main thread: all the subdocks first, then launchers and separators.
+	GPtrArray *array = g_ptr_array_new_full (pJobs->len, g_free);
+	for (i = 0; i < pJobs->len; i ++)
+	{
+		pJob = g_ptr_array_index (pJobs, i);
+		if (pJob->cOriginPath != NULL)
+			cairo_dock_prefetch_class_desktop_file (pJob->cOriginPath, pJob->pOriginKeyFile);
+		if (pJob->attr != NULL)
+		{
+			if (pJob->attr->iType == GLDI_USER_ICON_TYPE_STACK)
+			{
+				// this is a subdock, create it now
+				_load_one_icon (pJob->attr, NULL);
+				g_free (pJob->attr);
+			}
+			// this is a launcher or separator, save it for later, after all subdocks have been created
+			else g_ptr_array_add (array, pJob->attr);
+		}
+		g_free (pJob->cConfFileName);
+		g_free (pJob->cOriginPath);
+		g_free (pJob);
+	}
+	g_ptr_array_free (pJobs, TRUE);
+	
 	// we have created all subdock, load launchers and separators now
 	g_ptr_array_foreach (array, _load_one_icon, NULL);
 	g_ptr_array_free (array, TRUE);
+	
+	cairo_dock_clear_prefetched_class_desktop_files ();  // the ones that weren't used (the class was already known)
 }
 
 
@@ -32,6 +32,7 @@ GldiObjectManager myWindowObjectMgr;
 GList *s_pWindowsList = NULL;  // list of all window actors
 static gboolean s_bSortedByZ = FALSE;  // whether the list is currently sorted by z-order
 static gboolean s_bSortedByAge = FALSE;  // whether the list is currently sorted by age
+static GPtrArray *s_pWindowsByZ = NULL;  // window actors from bottom to top, if the backend gives the stacking order
 static GldiWindowManagerBackend s_backend = {0};
 
 
@@ -61,8 +62,32 @@ static int _compare_age (GldiWindowActor *actor1, GldiWindowActor *actor2)
 		return 0;
 }
 
+gboolean gldi_windows_set_stack_order (GldiWindowActor **pActors, guint iNbActors)
+{
+	if (s_pWindowsByZ == NULL)
+		s_pWindowsByZ = g_ptr_array_sized_new (iNbActors);
+	else if (s_pWindowsByZ->len == iNbActors && memcmp (s_pWindowsByZ->pdata, pActors, iNbActors * sizeof (gpointer)) == 0)
+		return FALSE;  // same order as before
+	
+	g_ptr_array_set_size (s_pWindowsByZ, iNbActors);
+	guint i;
+	for (i = 0; i < iNbActors; i ++)
+	{
+		pActors[i]->iStackOrder = i;
+		g_ptr_array_index (s_pWindowsByZ, i) = pActors[i];
+	}
+	return TRUE;
+}
+
 void gldi_windows_foreach (gboolean bOrderedByZ, GFunc callback, gpointer data)
 {
+	if (bOrderedByZ && s_pWindowsByZ != NULL)  // already in order, no need to sort the list.
+	{
+		guint i;
+		for (i = 0; i < s_pWindowsByZ->len; i ++)
+			callback (g_ptr_array_index (s_pWindowsByZ, i), data);
+		return;
+	}
 	if (bOrderedByZ && ! s_bSortedByZ)
 	{
 		s_pWindowsList = g_list_sort (s_pWindowsList, (GCompareFunc)_compare_z_order);
@@ -424,6 +449,11 @@ static void init_object (GldiObject *obj, G_GNUC_UNUSED gpointer attr)
 {
 	GldiWindowActor *actor = (GldiWindowActor*)obj;
 	s_pWindowsList = g_list_prepend (s_pWindowsList, actor);
+	if (s_pWindowsByZ != NULL)  // place it on top until the backend tells us its actual place.
+	{
+		actor->iStackOrder = s_pWindowsByZ->len;
+		g_ptr_array_add (s_pWindowsByZ, actor);
+	}
 }
 
 static void reset_object (GldiObject *obj)
@@ -434,6 +464,8 @@ static void reset_object (GldiObject *obj)
 	g_free (actor->cWmClass);
 	g_free (actor->cLastAttentionDemand);
 	s_pWindowsList = g_list_remove (s_pWindowsList, actor);
+	if (s_pWindowsByZ != NULL)
+		g_ptr_array_remove (s_pWindowsByZ, actor);  // keeps the order of the others.
 }
 
 void gldi_register_windows_manager (void)
@@ -109,6 +109,13 @@ void gldi_windows_manager_register_backend (GldiWindowManagerBackend *pBackend);
 
 const gchar *gldi_windows_manager_get_name ();
 
+/** Give the stacking order of the windows. It is meant to be used by the backends that know it, so that the actors are kept in this order and never have to be sorted. Their iStackOrder is updated.
+*@param pActors the window actors, from bottom to top
+*@param iNbActors number of actors
+*@return TRUE if the order has changed since the last time.
+*/
+gboolean gldi_windows_set_stack_order (GldiWindowActor **pActors, guint iNbActors);
+
 /** Run a function on each window actor.
 *@param bOrderedByZ TRUE to sort by z-order, FALSE to sort by age
 *@param callback the callback
@@ -69,6 +69,7 @@
 #include <gldit/cairo-dock-opengl-path.h>
 #include <gldit/cairo-dock-opengl-font.h>
 #include <gldit/cairo-dock-draw-opengl.h>
+#include <gldit/cairo-dock-icon-atlas.h>
 #include <gldit/cairo-dock-draw.h>
 #include <gldit/cairo-dock-overlay.h>
 #include <gldit/cairo-dock-dock-facility.h>
@@ -90,10 +91,12 @@
 #include <gldit/cairo-dock-keyfile-utilities.h>
 #include <gldit/cairo-dock-keybinder.h>
 #include <gldit/cairo-dock-task.h>
+#include <gldit/cairo-dock-profiler.h>
 #include <gldit/cairo-dock-particle-system.h>
 #include <gldit/cairo-dock-packages.h>
 #include <gldit/cairo-dock-surface-factory.h>
 #include <gldit/cairo-dock-image-buffer.h>
+#include <gldit/cairo-dock-image-cache.h>
 #include <gldit/cairo-dock-style-facility.h>
 #include <gldit/cairo-dock-style-manager.h>
 
@@ -106,6 +106,9 @@ static GHashTable *s_hXWindowTable = NULL;  // table of (Xid,actor)
 static GHashTable *s_hXClientMessageTable = NULL;  // table of (Xid,client-message)
 static int s_iTime = 1;  // on peut aller jusqu'a 2^31, soit 17 ans a 4Hz.
 static int s_iNumWindow = 1;  // used to order appli icons by age (=creation date).
+static Window *s_pLastXWindowsList = NULL;  // the list of windows we got the last time, to only handle the changes.
+static gulong s_iNbLastXWindows = 0;
+static gboolean s_bForceWindowsListUpdate = FALSE;  // TRUE when a window has been removed from the table while still being in the list.
 static Window s_iCurrentActiveWindow = 0;
 static guint num_lock_mask=0, caps_lock_mask=0, scroll_lock_mask=0;
 static GPollFD s_poll_fd;
@@ -134,33 +137,23 @@ struct _GldiXWindowActor {
 	};
 
 
-static GldiXWindowActor *_make_new_actor (Window Xid)
+static GldiXWindowActor *_make_new_actor (CairoDockXWindowProperties *pProps)
 {
 	GldiXWindowActor *xactor;
-	gboolean bShowInTaskbar = FALSE;
-	gboolean bNormalWindow = FALSE;
-	Window iTransientFor = None;
-	gchar *cClass = NULL, *cWmClass = NULL;
-	gboolean bIsHidden = FALSE, bIsFullScreen = FALSE, bIsMaximized = FALSE, bDemandsAttention = FALSE, bIsSticky = FALSE;
+	Window Xid = pProps->Xid;
+	gboolean bShowInTaskbar = pProps->bShowInTaskbar;  // check its 'skip taskbar' property
 	
 	//\__________________ see if we should skip it
-	// check its 'skip taskbar' property
-	bShowInTaskbar = cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention, &bIsSticky);
-	
 	if (bShowInTaskbar)
 	{
 		// check its type
-		bNormalWindow = cairo_dock_get_xwindow_type (Xid, &iTransientFor);
-		if (bNormalWindow || iTransientFor != None)
+		if (pProps->bNormalWindow || pProps->iTransientFor != None)
 		{
 			// check get its class
-			cClass = cairo_dock_get_xwindow_class (Xid, &cWmClass);
-			if (cClass == NULL)
+			if (pProps->cClass == NULL)
 			{
-				gchar *cName = cairo_dock_get_xwindow_name (Xid, TRUE);
 				cd_warning ("this window (%s, %ld) doesn't belong to any class, skip it.\n"
-					"Please report this bug to the application's devs.", cName, Xid);
-				g_free (cName);
+					"Please report this bug to the application's devs.", pProps->cName, Xid);
 				bShowInTaskbar = FALSE;
 			}
 		}
@@ -170,24 +163,21 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 			bShowInTaskbar = FALSE;
 		}
 	}
-	else
-	{
-		XGetTransientForHint (s_XDisplay, Xid, &iTransientFor);
-	}
 	
 	//\__________________ if the window passed all the tests, make a new actor
 	if (bShowInTaskbar)  // make a new actor and fill the properties we got before
 	{
-		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, &Xid);
+		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, pProps);
 		GldiWindowActor *actor = (GldiWindowActor*)xactor;
-		actor->bDisplayed = bNormalWindow;
-		actor->cClass = cClass;
-		actor->cWmClass = cWmClass;
-		actor->bIsHidden = bIsHidden;
-		actor->bIsMaximized = bIsMaximized;
-		actor->bIsFullScreen = bIsFullScreen;
-		actor->bDemandsAttention = bDemandsAttention;
-		actor->bIsSticky = bIsSticky;
+		actor->bDisplayed = pProps->bNormalWindow;
+		actor->cClass = pProps->cClass;
+		actor->cWmClass = pProps->cWmClass;
+		actor->bIsHidden = pProps->bIsHidden;
+		actor->bIsMaximized = pProps->bIsMaximized;
+		actor->bIsFullScreen = pProps->bIsFullScreen;
+		actor->bDemandsAttention = pProps->bDemandsAttention;
+		actor->bIsSticky = pProps->bIsSticky;
+		pProps->cClass = pProps->cWmClass = pProps->cName = NULL;  // taken by the actor
 	}
 	else  // make a dumy actor, so that we don't try to check it any more
 	{
@@ -201,8 +191,9 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 		*pXid = xactor->Xid;
 		g_hash_table_insert (s_hXWindowTable, pXid, xactor);
 	}
-	xactor->XTransientFor = iTransientFor;
-	((GldiWindowActor*)xactor)->bIsTransientFor = (iTransientFor != None);
+	cairo_dock_free_xwindow_properties (pProps);
+	xactor->XTransientFor = pProps->iTransientFor;
+	((GldiWindowActor*)xactor)->bIsTransientFor = (pProps->iTransientFor != None);
 	xactor->iLastCheckTime = s_iTime;
 	return xactor;
 }
@@ -297,17 +288,46 @@ static gboolean _remove_old_applis (Window *Xid, GldiXWindowActor *actor, gpoint
 	}
 	return FALSE;
 }
+static void _remember_windows_list (Window *pXWindowsList, gulong iNbWindows)
+{
+	g_free (s_pLastXWindowsList);
+	s_pLastXWindowsList = (iNbWindows != 0 ? g_memdup2 (pXWindowsList, iNbWindows * sizeof (Window)) : NULL);
+	s_iNbLastXWindows = iNbWindows;
+}
+
 static void _on_update_applis_list (void)
 {
-	s_iTime ++;
 	// get all windows sorted by z-order
 	gulong i, iNbWindows = 0;
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, TRUE);  // TRUE => ordered by z-stack.
 	
-	// set the z-order of existing windows, and create actors for new windows
+	// if nothing has changed since the last time (no new window, no closed window, same order), there is nothing to do.
+	if (! s_bForceWindowsListUpdate
+	&& iNbWindows == s_iNbLastXWindows
+	&& (iNbWindows == 0 || memcmp (pXWindowsList, s_pLastXWindowsList, iNbWindows * sizeof (Window)) == 0))
+	{
+		if (pXWindowsList != NULL)
+			XFree (pXWindowsList);
+		return;
+	}
+	s_bForceWindowsListUpdate = FALSE;
+	s_iTime ++;
+	
+	// get the properties of the new windows all at once
 	Window Xid;
+	Window *pNewXids = g_new (Window, iNbWindows);
+	guint iNbNewWindows = 0, iNewWindow = 0;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		if (g_hash_table_lookup (s_hXWindowTable, &pXWindowsList[i]) == NULL)
+			pNewXids[iNbNewWindows ++] = pXWindowsList[i];
+	}
+	CairoDockXWindowProperties *pProps = g_new (CairoDockXWindowProperties, iNbNewWindows);
+	cairo_dock_get_xwindows_properties (pNewXids, iNbNewWindows, pProps);
+	
+	// get the z-order of existing windows, and create actors for new windows
 	GldiXWindowActor *actor;
-	int iStackOrder = 0;
+	GPtrArray *pStack = g_ptr_array_sized_new (iNbWindows);
 	for (i = 0; i < iNbWindows; i ++)
 	{
 		Xid = pXWindowsList[i];
@@ -318,7 +338,16 @@ static void _on_update_applis_list (void)
 		{
 			// create a window actor
 			cd_message (" cette fenetre (%ld) de la pile n'est pas dans la liste", Xid);
-			actor = _make_new_actor (Xid);
+			for (; iNewWindow < iNbNewWindows && pProps[iNewWindow].Xid != Xid; iNewWindow ++)  // skip the duplicates of the list (shouldn't happen)
+				cairo_dock_free_xwindow_properties (&pProps[iNewWindow]);
+			if (iNewWindow < iNbNewWindows)
+				actor = _make_new_actor (&pProps[iNewWindow ++]);
+			else  // not in the batch (shouldn't happen either), get its properties alone.
+			{
+				CairoDockXWindowProperties props;
+				cairo_dock_get_xwindows_properties (&Xid, 1, &props);
+				actor = _make_new_actor (&props);
+			}
 			
 			// notify everybody
 			if (! actor->bIgnored)
@@ -327,18 +356,33 @@ static void _on_update_applis_list (void)
 		else  // just update its check-time
 			actor->iLastCheckTime = s_iTime;
 		
-		// update the z-order
+		// z-order
 		if (! actor->bIgnored)
-			actor->actor.iStackOrder = iStackOrder ++;
+			g_ptr_array_add (pStack, actor);
 	}
 	
-	// remove old actors for windows that disappeared
-	g_hash_table_foreach_remove (s_hXWindowTable, (GHRFunc) _remove_old_applis, GINT_TO_POINTER (s_iTime));
+	for (; iNewWindow < iNbNewWindows; iNewWindow ++)
+		cairo_dock_free_xwindow_properties (&pProps[iNewWindow]);
+	g_free (pProps);
+	g_free (pNewXids);
 	
-	// notify everybody that the stack order has changed
-	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
+	// remove old actors for windows that disappeared; they can only be in the previous list.
+	for (i = 0; i < s_iNbLastXWindows; i ++)
+	{
+		Xid = s_pLastXWindowsList[i];
+		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (actor != NULL && _remove_old_applis (&Xid, actor, GINT_TO_POINTER (s_iTime)))
+			g_hash_table_remove (s_hXWindowTable, &Xid);
+	}
+	
+	// notify everybody if the stack order has changed
+	if (gldi_windows_set_stack_order ((GldiWindowActor**)pStack->pdata, pStack->len))
+		gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
+	g_ptr_array_free (pStack, TRUE);
 	
-	XFree (pXWindowsList);
+	_remember_windows_list (pXWindowsList, iNbWindows);
+	if (pXWindowsList != NULL)
+		XFree (pXWindowsList);
 }
 
 static void _set_demand_attention (GldiXWindowActor *actor, XAttentionFlag flag)
@@ -602,6 +646,9 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 							g_hash_table_remove (s_hXWindowTable, &Xid);  // remove it explicitly, because the 'unref' might not free it
 							xactor->iLastCheckTime = -1;
 							_delete_actor (xactor);  // unref it since we don't need it anymore
+							// the windows list has not changed, so force the update, otherwise it would be skipped and the window would never come back.
+							s_bForceWindowsListUpdate = TRUE;
+							_on_update_applis_list ();
 						}
 						else  // is now ignored
 						{
@@ -1598,12 +1645,14 @@ static void init (void)
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, FALSE);  // ordered by creation date; this allows us to set the correct age to the icon, which is constant. On the next updates, the z-order (which is dynamic) will be set.
 	cd_debug ("got %d X windows", iNbWindows);
 	
-	Window Xid;
+	CairoDockXWindowProperties *pProps = g_new (CairoDockXWindowProperties, iNbWindows);
+	cairo_dock_get_xwindows_properties (pXWindowsList, iNbWindows, pProps);  // all at once
 	for (i = 0; i < iNbWindows; i ++)
 	{
-		Xid = pXWindowsList[i];
-		(void)_make_new_actor (Xid);
+		(void)_make_new_actor (&pProps[i]);
 	}
+	g_free (pProps);
+	_remember_windows_list (pXWindowsList, iNbWindows);  // not in z-order, so the first update will set it.
 	if (pXWindowsList != NULL)
 		XFree (pXWindowsList);
 	
@@ -1708,17 +1757,16 @@ static void init_object (GldiObject *obj, gpointer attr)
 {
 	GldiXWindowActor *xactor = (GldiXWindowActor*)obj;
 	GldiWindowActor *actor = (GldiWindowActor*)xactor;
-	Window *xid = (Window*)attr;
-	Window Xid = *xid;
+	CairoDockXWindowProperties *pProps = (CairoDockXWindowProperties*)attr;
+	Window Xid = pProps->Xid;
 	
 	xactor->Xid = Xid;
 	
-	// get additional properties
-	actor->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
-	actor->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+	// get additional properties (they have been fetched along with the other ones)
+	actor->cName = pProps->cName;
+	actor->iNumDesktop = pProps->iNumDesktop;
 	
-	int iLocalPositionX=0, iLocalPositionY=0, iWidthExtent=0, iHeightExtent=0;
-	cairo_dock_get_xwindow_geometry (Xid, &iLocalPositionX, &iLocalPositionY, &iWidthExtent, &iHeightExtent);
+	int iLocalPositionX = pProps->iLocalPositionX, iLocalPositionY = pProps->iLocalPositionY, iWidthExtent = pProps->iWidthExtent, iHeightExtent = pProps->iHeightExtent;
 	
 	actor->iViewPortX = iLocalPositionX / g_desktopGeometry.Xscreen.width + g_desktopGeometry.iCurrentViewportX;
 	actor->iViewPortY = iLocalPositionY / g_desktopGeometry.Xscreen.height + g_desktopGeometry.iCurrentViewportY;
@@ -31,6 +31,11 @@
 #endif
 #include <X11/extensions/Xrandr.h>
 #endif
+#ifdef HAVE_XCB
+#include <stdlib.h>  // free
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#endif
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-utils.h"  // cairo_dock_remove_version_from_string, cairo_dock_check_xrandr
@@ -1226,16 +1231,8 @@ void cairo_dock_xwindow_is_above_or_below (Window Xid, gboolean *bIsAbove, gbool
 	XFree (pXStateBuffer);
 }
 
-gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+static gboolean _parse_xwindow_state (const gulong *pXStateBuffer, gulong iBufferNbElements, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
 {
-	g_return_val_if_fail (Xid > 0, FALSE);
-	//cd_debug ("%s (%d)", __func__, Xid);
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
-	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
-	
 	gboolean bValid = TRUE;
 	*bIsFullScreen = FALSE;
 	*bIsHidden = FALSE;
@@ -1285,6 +1282,20 @@ gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gb
 			}
 		}
 	}
+	return bValid;
+}
+
+gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+{
+	g_return_val_if_fail (Xid > 0, FALSE);
+	//cd_debug ("%s (%d)", __func__, Xid);
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pXStateBuffer = NULL;
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	
+	gboolean bValid = _parse_xwindow_state (pXStateBuffer, iBufferNbElements, bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky);
 	
 	XFree (pXStateBuffer);
 	return bValid;
@@ -1421,13 +1432,71 @@ Window cairo_dock_get_active_xwindow (void)
 
 
 
-cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight)
+#define CD_MAX_NB_XICONS 32  // more icons in _NET_WM_ICON is certainly a broken property.
+#define CD_MAX_XICON_SIZE 4096
+// _NET_WM_ICON often holds many sizes of the icon (up to several hundreds of KB), so first read the size of each of them, and then only fetch the smallest one that is at least as big as the target size (or the biggest one).
+static gulong *_get_best_xicon (Window Xid, int iTargetSize, unsigned long *iBufferNbElements)
 {
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
+	unsigned long iLeftBytes = 0, iNbElements = 0;
+	gulong *pHeader;
+	long iOffset = 0, iBestOffset = -1;
+	gulong w, h, iSize, iBestSize = 0, iBestNbElements = 0;
+	int n;
+	*iBufferNbElements = 0;
+	
+	//\____________________ read the headers (width, height) of the icons.
+	for (n = 0; n < CD_MAX_NB_XICONS; n ++)
+	{
+		pHeader = NULL;
+		XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, iOffset, 2, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iNbElements, &iLeftBytes, (guchar **)&pHeader);
+		if (pHeader == NULL)
+			break;
+		if (iNbElements < 2 || aReturnedFormat != 32)
+		{
+			XFree (pHeader);
+			break;
+		}
+		w = pHeader[0];
+		h = pHeader[1];
+		XFree (pHeader);
+		if (w == 0 || h == 0 || w > CD_MAX_XICON_SIZE || h > CD_MAX_XICON_SIZE || w * h * 4 > iLeftBytes)  // broken icon, keep the ones we already found.
+			break;
+		
+		iSize = MAX (w, h);
+		if (iBestOffset < 0
+		|| (iSize >= (gulong)iTargetSize && (iSize < iBestSize || iBestSize < (gulong)iTargetSize))
+		|| (iSize < (gulong)iTargetSize && iSize > iBestSize && iBestSize < (gulong)iTargetSize))
+		{
+			iBestOffset = iOffset;
+			iBestSize = iSize;
+			iBestNbElements = 2 + w * h;
+		}
+		
+		iOffset += 2 + w * h;  // offset and length are in 32 bits units.
+		if (iLeftBytes == w * h * 4)  // it was the last icon.
+			break;
+	}
+	if (iBestOffset < 0)
+		return NULL;
+	
+	//\____________________ fetch the chosen icon only.
 	gulong *pXIconBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, iBestOffset, iBestNbElements, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
+	if (pXIconBuffer != NULL && *iBufferNbElements < iBestNbElements)  // the property has changed in the meantime.
+	{
+		XFree (pXIconBuffer);
+		pXIconBuffer = NULL;
+		*iBufferNbElements = 0;
+	}
+	return pXIconBuffer;
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight)
+{
+	unsigned long iBufferNbElements = 0;
+	gulong *pXIconBuffer = _get_best_xicon (Xid, MAX (iWidth, iHeight), &iBufferNbElements);
 
 	if (iBufferNbElements > 2)
 	{
@@ -1693,14 +1762,9 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	return cCommand;
 }*/
 
-gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+static gboolean _parse_xwindow_type (const gulong *pTypeBuffer, gulong iBufferNbElements, Window iTransientFor, Window *pTransientFor)
 {
 	gboolean bKeep = FALSE;  // we only want to know if we can display this window in the dock or not, so a boolean is enough.
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements;
-	gulong *pTypeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
 	if (iBufferNbElements != 0)
 	{
 		guint i;
@@ -1713,7 +1777,7 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 			}
 			if (pTypeBuffer[i] == s_aNetWmWindowTypeDialog)  // dialog -> skip modal dialog, because we can't act on it independantly from the parent window (it's most probably a dialog box like an open/save dialog)
 			{
-				XGetTransientForHint (s_XDisplay, Xid, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
+				*pTransientFor = iTransientFor;  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
 				if (*pTransientFor == None)
 				{
 					bKeep = TRUE;
@@ -1725,14 +1789,271 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 				break;
 			}
 		}
-		XFree (pTypeBuffer);
 	}
 	else  // no type, take it by default, unless it's transient.
 	{
-		XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+		*pTransientFor = iTransientFor;
 		bKeep = (*pTransientFor == None);
 	}
 	return bKeep;
 }
 
+gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+{
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pTypeBuffer = NULL;
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
+	
+	// the 'transient for' hint is only needed for dialogs and windows without type.
+	Window iTransientFor = None;
+	gboolean bNeedsTransientFor = (iBufferNbElements == 0);
+	guint i;
+	for (i = 0; i < iBufferNbElements && ! bNeedsTransientFor; i ++)
+		bNeedsTransientFor = (pTypeBuffer[i] == s_aNetWmWindowTypeDialog);
+	if (bNeedsTransientFor)
+		XGetTransientForHint (s_XDisplay, Xid, &iTransientFor);
+	
+	gboolean bKeep = _parse_xwindow_type (pTypeBuffer, iBufferNbElements, iTransientFor, pTransientFor);
+	
+	if (pTypeBuffer)
+		XFree (pTypeBuffer);
+	return bKeep;
+}
+
+
+  ////////////////////
+ // BATCHED FETCH //
+////////////////////
+
+#ifdef HAVE_XCB
+typedef struct {
+	xcb_get_property_cookie_t state, type, transient, wmclass, netname, wmname, desktop, extents;
+	xcb_get_geometry_cookie_t geometry;
+	xcb_translate_coordinates_cookie_t position;
+	} CairoDockXWindowCookies;
+
+static inline xcb_get_property_cookie_t _request_property (xcb_connection_t *c, Window Xid, Atom aProperty, Atom aType)
+{
+	return xcb_get_property (c, 0, Xid, aProperty, aType, 0, G_MAXUINT32);
+}
+
+static xcb_get_property_reply_t *_get_property_reply (xcb_connection_t *c, xcb_get_property_cookie_t cookie)
+{
+	xcb_generic_error_t *pError = NULL;
+	xcb_get_property_reply_t *pReply = xcb_get_property_reply (c, cookie, &pError);  // errors (the window has been destroyed meanwhile) are just ignored.
+	free (pError);
+	return pReply;
+}
+
+// XCB gives the values of format 32 as 32 bits integers, whereas Xlib gives them as longs; convert them so that they can be parsed the same way.
+static gulong *_get_property_longs (xcb_get_property_reply_t *pReply, gulong *iNbElements)
+{
+	*iNbElements = 0;
+	if (pReply == NULL || pReply->format != 32)
+		return NULL;
+	int n = xcb_get_property_value_length (pReply) / 4;
+	if (n <= 0)
+		return NULL;
+	const uint32_t *pValues = xcb_get_property_value (pReply);
+	gulong *pBuffer = g_new (gulong, n);
+	int i;
+	for (i = 0; i < n; i ++)
+		pBuffer[i] = pValues[i];
+	*iNbElements = n;
+	return pBuffer;
+}
+
+static gchar *_get_property_string (xcb_get_property_reply_t *pReply)
+{
+	if (pReply == NULL || pReply->format != 8)
+		return NULL;
+	int n = xcb_get_property_value_length (pReply);
+	if (n <= 0)
+		return NULL;
+	return g_strndup (xcb_get_property_value (pReply), n);
+}
+
+static void _get_xwindows_properties_xcb (xcb_connection_t *c, const Window *pXids, guint iNbWindows, CairoDockXWindowProperties *pProps)
+{
+	Window root = DefaultRootWindow (s_XDisplay);
+	Atom aWmTransientFor = XA_WM_TRANSIENT_FOR, aWmClass = XA_WM_CLASS;
+	Atom aNetFrameExtents = XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False);
+	guint i;
+	
+	//\__________________ send all the requests for all the windows at once.
+	CairoDockXWindowCookies *pCookies = g_new (CairoDockXWindowCookies, iNbWindows);
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		Window Xid = pXids[i];
+		pCookies[i].state     = _request_property (c, Xid, s_aNetWmState, XA_ATOM);
+		pCookies[i].type      = _request_property (c, Xid, s_aNetWmWindowType, XA_ATOM);
+		pCookies[i].transient = _request_property (c, Xid, aWmTransientFor, XA_WINDOW);
+		pCookies[i].wmclass   = _request_property (c, Xid, aWmClass, XA_STRING);
+		pCookies[i].netname   = _request_property (c, Xid, s_aNetWmName, s_aUtf8String);
+		pCookies[i].wmname    = _request_property (c, Xid, s_aWmName, s_aString);
+		pCookies[i].desktop   = _request_property (c, Xid, s_aNetWmDesktop, XA_CARDINAL);
+		pCookies[i].extents   = _request_property (c, Xid, aNetFrameExtents, XA_CARDINAL);
+		pCookies[i].geometry  = xcb_get_geometry (c, Xid);
+		pCookies[i].position  = xcb_translate_coordinates (c, Xid, root, 0, 0);
+	}
+	
+	//\__________________ then collect the replies; they all arrive during the same round trip.
+	xcb_get_property_reply_t *pReply;
+	xcb_generic_error_t *pError;
+	gulong *pBuffer, iNbElements;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		CairoDockXWindowProperties *p = &pProps[i];
+		memset (p, 0, sizeof (CairoDockXWindowProperties));
+		p->Xid = pXids[i];
+		
+		// state
+		pReply = _get_property_reply (c, pCookies[i].state);
+		pBuffer = _get_property_longs (pReply, &iNbElements);
+		p->bShowInTaskbar = _parse_xwindow_state (pBuffer, iNbElements, &p->bIsFullScreen, &p->bIsHidden, &p->bIsMaximized, &p->bDemandsAttention, &p->bIsSticky);
+		g_free (pBuffer);
+		free (pReply);
+		
+		// transient-for (like XGetTransientForHint)
+		Window iTransientFor = None;
+		pReply = _get_property_reply (c, pCookies[i].transient);
+		pBuffer = _get_property_longs (pReply, &iNbElements);
+		if (pReply != NULL && pReply->type == XA_WINDOW && iNbElements != 0)
+			iTransientFor = pBuffer[0];
+		g_free (pBuffer);
+		free (pReply);
+		
+		// type
+		pReply = _get_property_reply (c, pCookies[i].type);
+		pBuffer = _get_property_longs (pReply, &iNbElements);
+		if (p->bShowInTaskbar)
+			p->bNormalWindow = _parse_xwindow_type (pBuffer, iNbElements, iTransientFor, &p->iTransientFor);
+		else
+			p->iTransientFor = iTransientFor;
+		g_free (pBuffer);
+		free (pReply);
+		
+		// class (like XGetClassHint: "name\0class\0"; no class if there is only the name)
+		pReply = _get_property_reply (c, pCookies[i].wmclass);
+		if (pReply != NULL && pReply->type == XA_STRING && pReply->format == 8)
+		{
+			int n = xcb_get_property_value_length (pReply);
+			gchar *cData = g_strndup (xcb_get_property_value (pReply), MAX (n, 0));
+			gsize len_name = strlen (cData);
+			if ((int)len_name + 1 < n)
+			{
+				const gchar *cResClass = cData + len_name + 1;
+				p->cClass = gldi_window_parse_class (cResClass, cData);
+				p->cWmClass = g_strdup (cResClass);
+			}
+			g_free (cData);
+		}
+		free (pReply);
+		
+		// name
+		pReply = _get_property_reply (c, pCookies[i].netname);
+		p->cName = _get_property_string (pReply);
+		free (pReply);
+		pReply = _get_property_reply (c, pCookies[i].wmname);
+		if (p->cName == NULL)
+			p->cName = _get_property_string (pReply);
+		free (pReply);
+		
+		// desktop
+		pReply = _get_property_reply (c, pCookies[i].desktop);
+		pBuffer = _get_property_longs (pReply, &iNbElements);
+		p->iNumDesktop = (iNbElements > 0 ? (int)pBuffer[0] : 0);
+		g_free (pBuffer);
+		free (pReply);
+		
+		// geometry (like cairo_dock_get_xwindow_geometry)
+		pError = NULL;
+		xcb_get_geometry_reply_t *pGeometry = xcb_get_geometry_reply (c, pCookies[i].geometry, &pError);
+		free (pError);
+		if (pGeometry != NULL)
+		{
+			p->iWidthExtent = pGeometry->width;
+			p->iHeightExtent = pGeometry->height;
+			free (pGeometry);
+		}
+		pError = NULL;
+		xcb_translate_coordinates_reply_t *pPosition = xcb_translate_coordinates_reply (c, pCookies[i].position, &pError);
+		free (pError);
+		int x = 0, y = 0;
+		if (pPosition != NULL)
+		{
+			x = pPosition->dst_x;
+			y = pPosition->dst_y;
+			free (pPosition);
+		}
+		int left=0, right=0, top=0, bottom=0;
+		pReply = _get_property_reply (c, pCookies[i].extents);
+		pBuffer = _get_property_longs (pReply, &iNbElements);
+		if (iNbElements > 3)
+		{
+			left=pBuffer[0], right=pBuffer[1], top=pBuffer[2], bottom=pBuffer[3];
+		}
+		g_free (pBuffer);
+		free (pReply);
+		p->iLocalPositionX = x - left;
+		p->iLocalPositionY = y - top;
+		p->iWidthExtent += left + right;
+		p->iHeightExtent += top + bottom;
+	}
+	g_free (pCookies);
+}
+#endif
+
+static void _get_xwindow_properties (Window Xid, CairoDockXWindowProperties *p)
+{
+	memset (p, 0, sizeof (CairoDockXWindowProperties));
+	p->Xid = Xid;
+	p->bShowInTaskbar = cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &p->bIsFullScreen, &p->bIsHidden, &p->bIsMaximized, &p->bDemandsAttention, &p->bIsSticky);
+	if (p->bShowInTaskbar)
+	{
+		p->bNormalWindow = cairo_dock_get_xwindow_type (Xid, &p->iTransientFor);
+		if (p->bNormalWindow || p->iTransientFor != None)
+			p->cClass = cairo_dock_get_xwindow_class (Xid, &p->cWmClass);
+	}
+	else
+	{
+		XGetTransientForHint (s_XDisplay, Xid, &p->iTransientFor);
+	}
+	
+	// the remaining properties are only useful for the windows that will be displayed, so don't make the round trips for the other ones.
+	if (p->bShowInTaskbar && (p->bNormalWindow || p->iTransientFor != None))
+	{
+		p->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
+		p->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+		cairo_dock_get_xwindow_geometry (Xid, &p->iLocalPositionX, &p->iLocalPositionY, &p->iWidthExtent, &p->iHeightExtent);
+	}
+}
+
+void cairo_dock_get_xwindows_properties (const Window *pXids, guint iNbWindows, CairoDockXWindowProperties *pProps)
+{
+	if (iNbWindows == 0)
+		return;
+	#ifdef HAVE_XCB
+	xcb_connection_t *c = XGetXCBConnection (s_XDisplay);
+	if (c != NULL)
+	{
+		_get_xwindows_properties_xcb (c, pXids, iNbWindows, pProps);
+		return;
+	}
+	#endif
+	guint i;
+	for (i = 0; i < iNbWindows; i ++)
+		_get_xwindow_properties (pXids[i], &pProps[i]);
+}
+
+void cairo_dock_free_xwindow_properties (CairoDockXWindowProperties *pProps)
+{
+	g_free (pProps->cClass);
+	g_free (pProps->cWmClass);
+	g_free (pProps->cName);
+	pProps->cClass = pProps->cWmClass = pProps->cName = NULL;
+}
+
 #endif
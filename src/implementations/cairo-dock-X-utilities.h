@@ -123,6 +123,28 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap);
 
 gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor);
 
+/* Properties of a window that are needed to make its actor.
+*/
+typedef struct {
+	Window Xid;
+	gboolean bShowInTaskbar;  // FALSE if the window skips the taskbar
+	gboolean bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky;
+	gboolean bNormalWindow;  // TRUE if the type of the window can be displayed (only if bShowInTaskbar)
+	Window iTransientFor;
+	gchar *cClass, *cWmClass;
+	// the following ones may be left empty for a window that is not displayed.
+	gchar *cName;
+	int iNumDesktop;
+	int iLocalPositionX, iLocalPositionY, iWidthExtent, iHeightExtent;
+	} CairoDockXWindowProperties;
+
+/* Get the properties of several windows at once. With XCB, all the requests are sent before any reply is read, so that it costs one round trip to the X server for all the windows instead of about ten per window.
+* Free the strings with cairo_dock_free_xwindow_properties, unless they are taken.
+*/
+void cairo_dock_get_xwindows_properties (const Window *pXids, guint iNbWindows, CairoDockXWindowProperties *pProps);
+
+void cairo_dock_free_xwindow_properties (CairoDockXWindowProperties *pProps);
+
 gboolean cairo_dock_xcomposite_is_available (void);
 
 
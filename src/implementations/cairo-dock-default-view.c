@@ -237,26 +237,32 @@ static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 		fDockOffsetY = pDock->iDecorationsHeight + 1.5 * fLineWidth;
 	}
 
-	cairo_save (pCairoContext);
-	double fDeltaXTrapeze = cairo_dock_draw_frame (pCairoContext, fRadius, fLineWidth, fDockWidth, pDock->iDecorationsHeight, fDockOffsetX, fDockOffsetY, sens, 0., pDock->container.bIsHorizontal, myDocksParam.bRoundedBottomCorner);
+	// the frame and its decorations only change with the geometry of the dock, so they are drawn once in a layer.
+	cairo_t *pLayerContext = cairo_dock_begin_draw_dock_background_layer (pCairoContext, pDock, fDockOffsetX, fDockWidth);
+	if (pLayerContext != NULL)
+	{
+		cairo_save (pLayerContext);
+		double fDeltaXTrapeze = cairo_dock_draw_frame (pLayerContext, fRadius, fLineWidth, fDockWidth, pDock->iDecorationsHeight, fDockOffsetX, fDockOffsetY, sens, 0., pDock->container.bIsHorizontal, myDocksParam.bRoundedBottomCorner);
 
-	//\____________________ On dessine les decorations dedans.
-	fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
-	cairo_dock_render_decorations_in_frame (pCairoContext, pDock, fDockOffsetY, fDockOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
+		//\____________________ On dessine les decorations dedans.
+		fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+		cairo_dock_render_decorations_in_frame (pLayerContext, pDock, fDockOffsetY, fDockOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
 
-	//\____________________ On dessine le cadre.
-	if (fLineWidth > 0)
-	{
-		cairo_set_line_width (pCairoContext, fLineWidth);
-		if (myDocksParam.bUseDefaultColors)
-			gldi_style_colors_set_line_color (pCairoContext);
+		//\____________________ On dessine le cadre.
+		if (fLineWidth > 0)
+		{
+			cairo_set_line_width (pLayerContext, fLineWidth);
+			if (myDocksParam.bUseDefaultColors)
+				gldi_style_colors_set_line_color (pLayerContext);
+			else
+				gldi_color_set_cairo (pLayerContext, &myDocksParam.fLineColor);
+			cairo_stroke (pLayerContext);
+		}
 		else
-			gldi_color_set_cairo (pCairoContext, &myDocksParam.fLineColor);
-		cairo_stroke (pCairoContext);
+			cairo_new_path (pLayerContext);
+		cairo_restore (pLayerContext);
 	}
-	else
-		cairo_new_path (pCairoContext);
-	cairo_restore (pCairoContext);
+	cairo_dock_end_draw_dock_background_layer (pCairoContext, pDock, pLayerContext);
 
 	//\____________________ On dessine la ficelle qui les joint.
 	if (myIconsParam.iStringLineWidth > 0)
@@ -290,81 +296,95 @@ static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 static void cd_render_optimized_default (cairo_t *pCairoContext, CairoDock *pDock, GdkRectangle *pArea)
 {
 	//g_print ("%s ((%d;%d) x (%d;%d) / (%dx%d))\n", __func__, pArea->x, pArea->y, pArea->width, pArea->height, pDock->container.iWidth, pDock->container.iHeight);
-	double fLineWidth = myDocksParam.iDockLineWidth;
+	double fLineWidth = (myDocksParam.bUseDefaultColors ? myStyleParam.iLineWidth : myDocksParam.iDockLineWidth);  // same as the full rendering, since both can be mixed in the same window.
 	double fMargin = myDocksParam.iFrameMargin;
 	int iHeight = pDock->container.iHeight;
 
-	//\____________________ On dessine les decorations du fond sur la portion de fenetre.
-	cairo_save (pCairoContext);
-
-	double fDockOffsetX, fDockOffsetY;
-	if (pDock->container.bIsHorizontal)
+	if (pDock->pBackgroundLayer != NULL)  // the static background of the dock is up-to-date (the dock is at rest), just paint the damaged part of it.
 	{
-		fDockOffsetX = pArea->x;
-		fDockOffsetY = (pDock->container.bDirectionUp ? iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+		cairo_save (pCairoContext);
+		cairo_set_source_surface (pCairoContext, pDock->pBackgroundLayer, 0., 0.);
+		cairo_paint (pCairoContext);
+		cairo_restore (pCairoContext);
 	}
 	else
 	{
-		fDockOffsetX = (pDock->container.bDirectionUp ? iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
-		fDockOffsetY = pArea->y;
-	}
+		//\____________________ On dessine les decorations du fond sur la portion de fenetre.
+		cairo_save (pCairoContext);
 
-	if (pDock->container.bIsHorizontal)
-		cairo_rectangle (pCairoContext, fDockOffsetX, fDockOffsetY, pArea->width, pDock->iDecorationsHeight);
-	else
-		cairo_rectangle (pCairoContext, fDockOffsetX, fDockOffsetY, pDock->iDecorationsHeight, pArea->height);
+		double fDockOffsetX, fDockOffsetY;
+		if (pDock->container.bIsHorizontal)
+		{
+			fDockOffsetX = pArea->x;
+			fDockOffsetY = (pDock->container.bDirectionUp ? iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+		}
+		else
+		{
+			fDockOffsetX = (pDock->container.bDirectionUp ? iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+			fDockOffsetY = pArea->y;
+		}
+
+		if (pDock->container.bIsHorizontal)
+			cairo_rectangle (pCairoContext, fDockOffsetX, fDockOffsetY, pArea->width, pDock->iDecorationsHeight);
+		else
+			cairo_rectangle (pCairoContext, fDockOffsetX, fDockOffsetY, pDock->iDecorationsHeight, pArea->height);
 
-	fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+		fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
 	
-	double fRadius = MIN (myDocksParam.iDockRadius, (pDock->iDecorationsHeight + myDocksParam.iDockLineWidth) / 2 - 1);
-	double fOffsetX;
-	if (cairo_dock_is_extended_dock (pDock))  // mode panel etendu.
-	{
-		fOffsetX = fRadius + fLineWidth / 2;
-	}
-	else
-	{
-		Icon *pFirstIcon = cairo_dock_get_first_icon (pDock->icons);
-		fOffsetX = (pFirstIcon != NULL ? pFirstIcon->fX - fMargin : fRadius + fLineWidth / 2);
-	}
-	double fDockWidth = cairo_dock_get_current_dock_width_linear (pDock);
-	double fDeltaXTrapeze = fRadius;
-	cairo_dock_render_decorations_in_frame (pCairoContext, pDock, fDockOffsetY, fOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
+		double fRadius = MIN ((myDocksParam.bUseDefaultColors ? myStyleParam.iCornerRadius : myDocksParam.iDockRadius), (pDock->iDecorationsHeight + fLineWidth) / 2 - 1);
+		double fOffsetX;
+		if (cairo_dock_is_extended_dock (pDock))  // mode panel etendu.
+		{
+			fOffsetX = fRadius + fLineWidth / 2;
+		}
+		else
+		{
+			Icon *pFirstIcon = cairo_dock_get_first_icon (pDock->icons);
+			fOffsetX = (pFirstIcon != NULL ? pFirstIcon->fX - fMargin : fRadius + fLineWidth / 2);
+		}
+		double fDockWidth = cairo_dock_get_current_dock_width_linear (pDock);
+		double fDeltaXTrapeze = fRadius;
+		cairo_dock_render_decorations_in_frame (pCairoContext, pDock, fDockOffsetY, fOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
 	
-	//\____________________ On dessine la partie du cadre qui va bien.
-	if (myDocksParam.bUseDefaultColors)
-		gldi_style_colors_set_line_color (pCairoContext);
-	else
-		gldi_color_set_cairo (pCairoContext, &myDocksParam.fLineColor);
-	cairo_new_path (pCairoContext);
-
-	if (pDock->container.bIsHorizontal)
-	{
-		cairo_move_to (pCairoContext, fDockOffsetX, fDockOffsetY - fLineWidth / 2);
-		cairo_rel_line_to (pCairoContext, pArea->width, 0);
-		cairo_set_line_width (pCairoContext, fLineWidth);
-		cairo_stroke (pCairoContext);
-
+		//\____________________ On dessine la partie du cadre qui va bien.
+		if (myDocksParam.bUseDefaultColors)
+			gldi_style_colors_set_line_color (pCairoContext);
+		else
+			gldi_color_set_cairo (pCairoContext, &myDocksParam.fLineColor);
 		cairo_new_path (pCairoContext);
-		cairo_move_to (pCairoContext, fDockOffsetX, (pDock->container.bDirectionUp ? iHeight - fLineWidth / 2 : pDock->iDecorationsHeight + 1.5 * fLineWidth));
-		cairo_rel_line_to (pCairoContext, pArea->width, 0);
-		cairo_set_line_width (pCairoContext, fLineWidth);
-	}
-	else
-	{
-		cairo_move_to (pCairoContext, fDockOffsetX - fLineWidth / 2, fDockOffsetY);
-		cairo_rel_line_to (pCairoContext, 0, pArea->height);
-		cairo_set_line_width (pCairoContext, fLineWidth);
+
+		if (pDock->container.bIsHorizontal)
+		{
+			cairo_move_to (pCairoContext, fDockOffsetX, fDockOffsetY - fLineWidth / 2);
+			cairo_rel_line_to (pCairoContext, pArea->width, 0);
+			cairo_set_line_width (pCairoContext, fLineWidth);
+			cairo_stroke (pCairoContext);
+
+			cairo_new_path (pCairoContext);
+			cairo_move_to (pCairoContext, fDockOffsetX, (pDock->container.bDirectionUp ? iHeight - fLineWidth / 2 : pDock->iDecorationsHeight + 1.5 * fLineWidth));
+			cairo_rel_line_to (pCairoContext, pArea->width, 0);
+			cairo_set_line_width (pCairoContext, fLineWidth);
+		}
+		else
+		{
+			cairo_move_to (pCairoContext, fDockOffsetX - fLineWidth / 2, fDockOffsetY);
+			cairo_rel_line_to (pCairoContext, 0, pArea->height);
+			cairo_set_line_width (pCairoContext, fLineWidth);
+			cairo_stroke (pCairoContext);
+
+			cairo_new_path (pCairoContext);
+			cairo_move_to (pCairoContext, (pDock->container.bDirectionUp ? iHeight - fLineWidth / 2 : pDock->iDecorationsHeight + 1.5 * fLineWidth), fDockOffsetY);
+			cairo_rel_line_to (pCairoContext, 0, pArea->height);
+			cairo_set_line_width (pCairoContext, fLineWidth);
+		}
 		cairo_stroke (pCairoContext);
 
-		cairo_new_path (pCairoContext);
-		cairo_move_to (pCairoContext, (pDock->container.bDirectionUp ? iHeight - fLineWidth / 2 : pDock->iDecorationsHeight + 1.5 * fLineWidth), fDockOffsetY);
-		cairo_rel_line_to (pCairoContext, 0, pArea->height);
-		cairo_set_line_width (pCairoContext, fLineWidth);
+		cairo_restore (pCairoContext);
 	}
-	cairo_stroke (pCairoContext);
 
-	cairo_restore (pCairoContext);
+	//\____________________ On dessine la ficelle qui les joint.
+	if (myIconsParam.iStringLineWidth > 0)
+		cairo_dock_draw_string (pCairoContext, pDock, myIconsParam.iStringLineWidth, FALSE, FALSE);
 
 	//\____________________ On dessine les icones impactees.
 	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_OVER);
@@ -391,12 +411,6 @@ static void cd_render_optimized_default (cairo_t *pCairoContext, CairoDock *pDoc
 				cairo_save (pCairoContext);
 				//g_print ("dessin optimise de %s [%.2f -> %.2f]\n", icon->cName, fXLeft, fXRight);
 				
-				icon->fAlpha = 1;
-				if (icon->iAnimationState == CAIRO_DOCK_STATE_AVOID_MOUSE)
-				{
-					icon->fAlpha = 0.7;
-				}
-				
 				if (myIconsParam.iSeparatorType != CAIRO_DOCK_NORMAL_SEPARATOR && icon->cFileName == NULL && CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon))
 					_cairo_dock_draw_separator (icon, pDock, pCairoContext, fDockMagnitude);
 				else
@@ -624,6 +638,9 @@ static void cd_render_opengl_default (CairoDock *pDock)
 	if (pFirstDrawnElement == NULL)
 		return;
 	
+	// the plain icons and their reflects are drawn all at once, what goes on top of them is drawn in the loop below.
+	cairo_dock_render_icons_batch_opengl (pDock, pFirstDrawnElement, fDockMagnitude);
+	
 	Icon *icon;
 	GList *ic = pFirstDrawnElement;
 	do
@@ -683,6 +700,7 @@ void cairo_dock_register_default_renderer (void)
 	pDefaultRenderer->calculate_icons = cd_calculate_icons_default;
 	pDefaultRenderer->render = cd_render_default;
 	pDefaultRenderer->render_optimized = cd_render_optimized_default;
+	pDefaultRenderer->bCanRenderOptimized = TRUE;  // it draws the same as cd_render_default() for a dock at rest.
 	pDefaultRenderer->render_opengl = cd_render_opengl_default;
 	pDefaultRenderer->set_subdock_position = cairo_dock_set_subdock_position_linear;
 	pDefaultRenderer->bUseReflect = FALSE;
@@ -42,12 +42,222 @@ typedef struct _Graph {
 	GLuint iBackgroundTexture;
 	gint iMargin;
 	gboolean bMixGraphs;
+	// curves drawn so far, scrolled when new values arrive (line, plain and bar graphs only); 2 surfaces are used alternately.
+	cairo_surface_t *pCurvesSurface;
+	cairo_surface_t *pCurvesBackSurface;
+	guint iNbRenderedSamples;  // number of values that had been added when the curves were drawn.
+	gdouble *pRenderedMinMaxValues;  // range of the values when the curves were drawn.
 	} Graph;
 
 
 extern gboolean g_bUseOpenGL;
 
 
+// translate the context to the area of the i-th value, and set its color. Returns the height of the area (line and bar graphs).
+static int _set_graph_context (Graph *pGraph, cairo_t *pCairoContext, int i, double fHeight)
+{
+	int iMargin = pGraph->iMargin;
+	int iCurrentGraph, iGraphTop, iGraphBottom, iHeight = 0;
+	if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
+	{
+		if (! pGraph->bMixGraphs)
+			cairo_translate (pCairoContext,
+				0.,
+				i * fHeight);
+	}
+	else
+	{
+		iCurrentGraph = pGraph->bMixGraphs ? 0 : i;
+		iGraphTop = floor (iCurrentGraph * fHeight) + iMargin; // Position of previous graph axis (if any).
+		iGraphBottom = floor ((iCurrentGraph + 1) * fHeight) + iMargin; // Position of current graph axis
+		iHeight = iGraphBottom - iGraphTop; // Current graph height.
+		cairo_translate (pCairoContext,
+			iMargin,
+			iGraphTop);
+	}
+	cairo_pattern_t *pGradationPattern = pGraph->pGradationPatterns[i];
+	if (pGradationPattern != NULL)
+		cairo_set_source (pCairoContext, pGradationPattern);
+	else
+		cairo_set_source_rgb (pCairoContext,
+			pGraph->fLowColor[3*i+0],
+			pGraph->fLowColor[3*i+1],
+			pGraph->fLowColor[3*i+2]);
+	return iHeight;
+}
+
+// draw the n most recent values of the i-th value of a line or bar graph. If bPartial is TRUE, only these values are drawn, on top of the previous curve.
+static void _draw_graph_curve (Graph *pGraph, cairo_t *pCairoContext, int i, int iWidth, int iHeight, int n, gboolean bPartial)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	double fValue;
+	int t;
+	switch (pGraph->iType)
+	{
+		case CAIRO_DOCK_GRAPH_LINE:
+		case CAIRO_DOCK_GRAPH_PLAIN:
+		default :
+			cairo_set_line_width (pCairoContext, 1);
+			cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
+			fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
+			if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+				fValue = 0;
+			cairo_move_to (pCairoContext,
+				iWidth - .5,
+				(1 - fValue) * (iHeight - 1) + .5) ; // - .5 to align line draw on pixel and + 1 px down because size is reduced
+			for (t = 1; t < n; t ++)
+			{
+				fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
+				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+					fValue = 0;
+				cairo_line_to (pCairoContext,
+					iWidth - t - .5,
+					(1 - fValue) * (iHeight - 1) + .5); // - .5 to align line draw on pixel and + 1 px down because size is reduced
+			}
+			if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
+			{
+				cairo_line_to (pCairoContext,
+					bPartial ? iWidth - (n - 1) - .5 : .5, // - .5 to align line draw on pixel and + 1 to align with last value position
+					iHeight - .5); // - .5 to align next line draw on pixel
+				cairo_line_to (pCairoContext,
+					iWidth - .5,
+					iHeight - .5);
+				cairo_close_path (pCairoContext);
+				if (bPartial)  // the first value is only here to draw the line that joins it; its column is already filled, so fill from the first redrawn column.
+				{
+					cairo_path_t *pCurvePath = cairo_copy_path (pCairoContext);  // the clip consumes the current path, so set it aside.
+					cairo_new_path (pCairoContext);
+					cairo_save (pCairoContext);
+					cairo_rectangle (pCairoContext, iWidth - (n - 1), 0., n - 1, iHeight);
+					cairo_clip (pCairoContext);
+					cairo_append_path (pCairoContext, pCurvePath);
+					cairo_fill_preserve (pCairoContext);
+					cairo_restore (pCairoContext);  // the path is not part of the saved state, it's kept for the stroke
+					cairo_path_destroy (pCurvePath);
+				}
+				else
+					cairo_fill_preserve (pCairoContext);
+			}
+			cairo_stroke (pCairoContext);
+		break;
+		
+		case CAIRO_DOCK_GRAPH_BAR:
+		{
+			cairo_set_line_width (pCairoContext, 1);
+			for (t = 0; t < n; t ++)
+			{
+				fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
+				if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
+				{
+					cairo_move_to (pCairoContext,
+						iWidth - t - .5, // - .5 to align line draw on pixel
+						iHeight);
+					cairo_rel_line_to (pCairoContext,
+						0.,
+						- fValue * iHeight);
+					cairo_stroke (pCairoContext);
+				}
+			}
+		}
+		break;
+	}
+}
+
+static void _free_graph_curves (Graph *pGraph)
+{
+	if (pGraph->pCurvesSurface != NULL)
+	{
+		cairo_surface_destroy (pGraph->pCurvesSurface);
+		pGraph->pCurvesSurface = NULL;
+	}
+	if (pGraph->pCurvesBackSurface != NULL)
+	{
+		cairo_surface_destroy (pGraph->pCurvesBackSurface);
+		pGraph->pCurvesBackSurface = NULL;
+	}
+	g_free (pGraph->pRenderedMinMaxValues);
+	pGraph->pRenderedMinMaxValues = NULL;
+}
+
+// Line and bar graphs just scroll by 1 pixel per new value, so instead of drawing the whole history each time, we keep the curves in a surface, scroll it and only draw the new values.
+// The curves are drawn entirely the first time, when the range of the values changes, or when there are too many new values.
+static gboolean _render_graph_curves_incrementally (Graph *pGraph, cairo_t *pCairoContext, int iWidth, double fHeight)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN  // the whole graph turns
+	|| pData->iMemorySize < iWidth  // the curves don't fill the graph, which is drawn differently
+	|| iWidth < 3)
+	{
+		_free_graph_curves (pGraph);
+		return FALSE;
+	}
+	
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	int iMargin = pGraph->iMargin;
+	int i, iHeight;
+	int k = pData->iNbAddedSamples - pGraph->iNbRenderedSamples;  // number of new values.
+	gboolean bPartial = (pGraph->pCurvesSurface != NULL
+		&& (guint)k + 2 <= (guint)iWidth  // the line from the previous values to the new ones is drawn too
+		&& memcmp (pGraph->pRenderedMinMaxValues, pData->pMinMaxValues, 2 * iNbValues * sizeof (gdouble)) == 0);
+	
+	if (! bPartial || k != 0)
+	{
+		cairo_t *ctx;
+		if (pGraph->pCurvesSurface == NULL)
+		{
+			pGraph->pCurvesSurface = cairo_dock_create_blank_surface (pRenderer->iWidth, pRenderer->iHeight);
+			pGraph->pCurvesBackSurface = cairo_dock_create_blank_surface (pRenderer->iWidth, pRenderer->iHeight);
+			pGraph->pRenderedMinMaxValues = g_new (gdouble, 2 * iNbValues);
+		}
+		if (bPartial)  // scroll the current curves into the other surface, and clear the part to be redrawn.
+		{
+			ctx = cairo_create (pGraph->pCurvesBackSurface);
+			cairo_rectangle (ctx, iMargin, 0., iWidth, pRenderer->iHeight);  // don't scroll the curves into the left margin, which stays empty.
+			cairo_clip (ctx);
+			cairo_set_operator (ctx, CAIRO_OPERATOR_SOURCE);
+			cairo_set_source_surface (ctx, pGraph->pCurvesSurface, - k, 0.);
+			cairo_paint (ctx);
+			cairo_rectangle (ctx, iMargin + iWidth - k - 1, 0., k + 1, pRenderer->iHeight);  // the column of the previous value is redrawn too, since the line now goes further.
+			cairo_clip (ctx);
+			cairo_set_operator (ctx, CAIRO_OPERATOR_CLEAR);
+			cairo_paint (ctx);
+			cairo_set_operator (ctx, CAIRO_OPERATOR_OVER);
+			
+			cairo_surface_t *pSurface = pGraph->pCurvesSurface;
+			pGraph->pCurvesSurface = pGraph->pCurvesBackSurface;
+			pGraph->pCurvesBackSurface = pSurface;
+		}
+		else  // draw everything.
+		{
+			ctx = cairo_create (pGraph->pCurvesSurface);
+			cairo_set_operator (ctx, CAIRO_OPERATOR_CLEAR);
+			cairo_paint (ctx);
+			cairo_set_operator (ctx, CAIRO_OPERATOR_OVER);
+			cairo_rectangle (ctx, iMargin, 0., iWidth, pRenderer->iHeight);  // keep the curves inside the graph, so that they can be scrolled.
+			cairo_clip (ctx);
+		}
+		
+		for (i = 0; i < iNbValues; i ++)
+		{
+			cairo_save (ctx);
+			iHeight = _set_graph_context (pGraph, ctx, i, fHeight);
+			_draw_graph_curve (pGraph, ctx, i, iWidth, iHeight,
+				! bPartial ? iWidth : pGraph->iType == CAIRO_DOCK_GRAPH_BAR ? k + 1 : k + 2,  // redraw the previous value too; a line starts from the value before it, so that the segment between them is redrawn entirely.
+				bPartial);
+			cairo_restore (ctx);
+		}
+		cairo_destroy (ctx);
+		
+		pGraph->iNbRenderedSamples = pData->iNbAddedSamples;
+		memcpy (pGraph->pRenderedMinMaxValues, pData->pMinMaxValues, 2 * iNbValues * sizeof (gdouble));
+	}
+	
+	cairo_set_source_surface (pCairoContext, pGraph->pCurvesSurface, 0., 0.);
+	cairo_paint (pCairoContext);
+	return TRUE;
+}
+
 static void render (Graph *pGraph, cairo_t *pCairoContext)
 {
 	g_return_if_fail (pGraph != NULL);
@@ -73,93 +283,29 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 	double fHeight = pRenderer->iHeight - 2*iMargin;
 	fHeight /= iNbDrawings;
 	
+	int i;
+	if (_render_graph_curves_incrementally (pGraph, pCairoContext, iWidth, fHeight))
+	{
+		for (i = 0; i < iNbValues; i ++)
+			cairo_dock_render_overlays_to_context (pRenderer, i, pCairoContext);
+		return;
+	}
+	
 	double fValue;
-	cairo_pattern_t *pGradationPattern;
 	int t, n = MIN (pData->iMemorySize, iWidth);  // for iteration over the memorized values.
-	int i, iCurrentGraph, iGraphTop, iGraphBottom, iHeight = 0;
+	int iHeight;
 	for (i = 0; i < iNbValues; i ++)
 	{
 		cairo_save (pCairoContext);
-		if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
-		{
-			if (! pGraph->bMixGraphs)
-				cairo_translate (pCairoContext,
-					0.,
-					i * fHeight);
-		}
-		else
-		{
-			iCurrentGraph = pGraph->bMixGraphs ? 0 : i;
-			iGraphTop = floor (iCurrentGraph * fHeight) + iMargin; // Position of previous graph axis (if any).
-			iGraphBottom = floor ((iCurrentGraph + 1) * fHeight) + iMargin; // Position of current graph axis
-			iHeight = iGraphBottom - iGraphTop; // Current graph height.
-			cairo_translate (pCairoContext,
-				iMargin,
-				iGraphTop);
-		}
-		pGradationPattern = pGraph->pGradationPatterns[i];
-		if (pGradationPattern != NULL)
-			cairo_set_source (pCairoContext, pGradationPattern);
-		else
-			cairo_set_source_rgb (pCairoContext,
-				pGraph->fLowColor[3*i+0],
-				pGraph->fLowColor[3*i+1],
-				pGraph->fLowColor[3*i+2]);
+		iHeight = _set_graph_context (pGraph, pCairoContext, i, fHeight);
 		
 		switch (pGraph->iType)
 		{
 			case CAIRO_DOCK_GRAPH_LINE:
 			case CAIRO_DOCK_GRAPH_PLAIN:
-			default :
-				cairo_set_line_width (pCairoContext, 1);
-				cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
-				fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
-				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-					fValue = 0;
-				cairo_move_to (pCairoContext,
-					iWidth - .5,
-					(1 - fValue) * (iHeight - 1) + .5) ; // - .5 to align line draw on pixel and + 1 px down because size is reduced
-				for (t = 1; t < n; t ++)
-				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-						fValue = 0;
-					cairo_line_to (pCairoContext,
-						iWidth - t - .5,
-						(1 - fValue) * (iHeight - 1) + .5); // - .5 to align line draw on pixel and + 1 px down because size is reduced
-				}
-				if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
-				{
-					cairo_line_to (pCairoContext,
-						.5, // - .5 to align line draw on pixel and + 1 to align with last value position
-						iHeight - .5); // - .5 to align next line draw on pixel
-					cairo_rel_line_to (pCairoContext,
-						iWidth - 1,
-						0.);
-					cairo_close_path (pCairoContext);
-					cairo_fill_preserve (pCairoContext);
-				}
-				cairo_stroke (pCairoContext);
-			break;
-			
 			case CAIRO_DOCK_GRAPH_BAR:
-			{
-				cairo_set_line_width (pCairoContext, 1);
-				for (t = 0; t < n; t ++)
-				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
-					{
-						cairo_move_to (pCairoContext,
-							iWidth - t - .5, // - .5 to align line draw on pixel
-							iHeight);
-						cairo_rel_line_to (pCairoContext,
-							0.,
-							- fValue * iHeight);
-						cairo_stroke (pCairoContext);
-					}
-				}
-			}
+			default :
+				_draw_graph_curve (pGraph, pCairoContext, i, iWidth, iHeight, n, FALSE);
 			break;
 			
 			case CAIRO_DOCK_GRAPH_CIRCLE:
@@ -485,6 +631,7 @@ static void reload (Graph *pGraph)
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
 	int iWidth = pRenderer->iWidth, iHeight = pRenderer->iHeight;
 	pGraph->iMargin = floor (MIN (iWidth, iHeight) / 32);
+	_free_graph_curves (pGraph);  // the size has changed, draw the curves again.
 	if (pGraph->pBackgroundSurface != NULL)
 		cairo_surface_destroy (pGraph->pBackgroundSurface);
 	pGraph->pBackgroundSurface = _cairo_dock_create_graph_background (iWidth, iHeight, pGraph->iMargin, pGraph->fBackGroundColor, pGraph->iType, iNbValues / pRenderer->iRank);
@@ -516,6 +663,7 @@ static void unload (Graph *pGraph)
 		cairo_surface_destroy (pGraph->pBackgroundSurface);
 	if (pGraph->iBackgroundTexture != 0)
 		_cairo_dock_delete_texture (pGraph->iBackgroundTexture);
+	_free_graph_curves (pGraph);
 	
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);